@@ -0,0 +1,226 @@
+/*
+ * bench.cpp
+ * Microbenchmarks for the graph and chromosome primitives and for single GA/Ising cycles, run over every graph in
+ * data/ and over synthetic random graphs of increasing size.
+ * Usage: ./bench [--filter=<substring>] [--min-time-ms=<ms>] [--json=<path>] [--baseline=<path>] [--data-dir=<dir>] [--synthetic-sizes=<n1,n2,...>]
+ */
+
+#include "Benchmark.h"
+#include "RawMetisFile.h"
+#include "EdgeDenotedGraph.h"
+#include "CompressedGraph.h"
+#include "VertexCoverLP.h"
+#include "BitsetGraph.h"
+#include "Chromosome.h"
+#include "SolutionPool.h"
+#include "GraphGenerator.h"
+#include "GeneticAlgoSearch.h"
+#include "IsingMCAlgoSearch.h"
+#include "Random.h"
+#include "Utilities.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+
+using namespace std;
+
+// G(n, m) random graph with average degree avg_degree
+RawMetisFile synthetic_graph(int num_vertices, int avg_degree, int rand_seed) {
+    GeneratorParameters params;
+    params.num_vertices = num_vertices;
+    params.num_edges    = long(num_vertices) * avg_degree / 2;
+    params.rand_seed    = rand_seed;
+    return GraphGenerator(params).generate();
+}
+
+vector<int> random_bitfield(int size, double density, Random &ran3) {
+    vector<int> bitfield(size);
+    for (auto &bit : bitfield) bit = (ran3() < density) ? 1 : 0;
+    return bitfield;
+}
+
+void register_graph_benchmarks(BenchmarkRunner &runner, const string &name, const string &filepath) {
+    auto metis_file = make_shared<RawMetisFile>(filepath);
+    auto graph = make_shared<EdgeDenotedGraph>(*metis_file, false);
+    auto num_vertices = graph->num_vertices();
+    auto num_edges = graph->num_edges();
+
+    runner.add("BM_ParseMetis/" + name, [=](BenchmarkState &state) {
+        while (state.keep_running()) { RawMetisFile file(filepath); do_not_optimize(file.Connections); }
+        state.set_items_processed(state.iterations() * num_edges);
+    });
+
+    runner.add("BM_WriteMetis/" + name, [=](BenchmarkState &state) {
+        auto output_filepath = "bench_write_" + name + ".graph";
+        while (state.keep_running()) metis_file->write_to_file(output_filepath);
+        state.set_items_processed(state.iterations() * num_edges);
+        std::remove(output_filepath.c_str());
+    });
+
+    runner.add("BM_BuildEdgeDenotedGraph/" + name, [=](BenchmarkState &state) {
+        while (state.keep_running()) { EdgeDenotedGraph g(*metis_file); do_not_optimize(g); }
+        state.set_items_processed(state.iterations() * num_edges);
+    });
+
+    runner.add("BM_BuildAdjacencyOnlyGraph/" + name, [=](BenchmarkState &state) {
+        while (state.keep_running()) { EdgeDenotedGraph g(*metis_file, false); do_not_optimize(g); }
+        state.set_items_processed(state.iterations() * num_edges);
+    });
+
+    runner.add("BM_RemoveAddEdge/" + name, [=](BenchmarkState &state) {
+        auto g = make_shared<EdgeDenotedGraph>(*metis_file);
+        long i = 0;
+        while (state.keep_running()) {
+            auto edge_idx = int(i++ % num_edges);
+            auto nodes = g->get_edge_nodes(edge_idx);
+            g->remove_edge(edge_idx);
+            g->add_edge(edge_idx, nodes);
+        }
+    });
+
+    runner.add("BM_VertexCoverCheckUsingBitfield/" + name, [=](BenchmarkState &state) {
+        Random ran3(42);
+        auto bitfield = random_bitfield(num_vertices, 0.7, ran3);
+        while (state.keep_running()) { auto result = graph->vertex_cover_check_using_bitfield(bitfield); do_not_optimize(result); }
+        state.set_items_processed(state.iterations() * num_edges);
+    });
+
+    runner.add("BM_IncrementalEdgeCostOfBitFlip/" + name, [=](BenchmarkState &state) {
+        Random ran3(42);
+        auto bitfield = random_bitfield(num_vertices, 0.7, ran3);
+        vector<int> indices(4096);
+        for (auto &idx : indices) idx = int(ran3(num_vertices));
+        long i = 0;
+        while (state.keep_running()) { auto cost = graph->incremental_edge_cost_of_bit_flip(bitfield, indices[i++ & 4095]); do_not_optimize(cost); }
+    });
+
+    runner.add("BM_BuildCompressedGraph/" + name, [=](BenchmarkState &state) {
+        while (state.keep_running()) { CompressedGraph g(filepath); do_not_optimize(g); }
+        state.set_items_processed(state.iterations() * num_edges);
+    });
+
+    runner.add("BM_CompressedIncrementalEdgeCost/" + name, [=](BenchmarkState &state) {
+        Random ran3(42);
+        CompressedGraph g(filepath);
+        auto bitfield = random_bitfield(num_vertices, 0.7, ran3);
+        vector<int> indices(4096);
+        for (auto &idx : indices) idx = int(ran3(num_vertices));
+        long i = 0;
+        while (state.keep_running()) { auto cost = g.incremental_edge_cost_of_bit_flip(bitfield, indices[i++ & 4095]); do_not_optimize(cost); }
+    });
+
+    runner.add("BM_SolveVertexCoverLP/" + name, [=](BenchmarkState &state) {
+        while (state.keep_running()) { VertexCoverLP lp(*graph); lp.solve(); do_not_optimize(lp); }
+        state.set_items_processed(state.iterations() * num_edges);
+    });
+
+    runner.add("BM_VertexCoverLPToggleVertex/" + name, [=](BenchmarkState &state) {
+        // One deactivate/activate pair, as branch and bound does on descending to a vertex and backtracking
+        Random ran3(42);
+        VertexCoverLP lp(*graph);
+        lp.solve();
+        vector<int> indices(4096);
+        for (auto &idx : indices) idx = int(ran3(num_vertices));
+        long i = 0;
+        while (state.keep_running()) { auto v = indices[i++ & 4095]; lp.deactivate(v); lp.activate(v); }
+        do_not_optimize(lp);
+    });
+
+    if (num_vertices <= BitsetGraph::MAX_VERTICES) {
+        runner.add("BM_CliqueCoverBound/" + name, [=](BenchmarkState &state) {
+            vector<int> vertices(num_vertices);
+            for (int v=0; v < num_vertices; ++v) vertices[v] = v;
+            BitsetGraph g(*graph, vertices);
+            auto all = g.all_vertices();
+            while (state.keep_running()) { auto bound = g.clique_cover_bound(all); do_not_optimize(bound); }
+            state.set_items_processed(state.iterations() * num_vertices);
+        });
+    }
+
+    runner.add("BM_PerformCrossover/" + name, [=](BenchmarkState &state) {
+        Random ran3(42);
+        Chromosome a(random_bitfield(num_vertices, 0.7, ran3)), b(random_bitfield(num_vertices, 0.7, ran3));
+        while (state.keep_running()) { a.perform_crossover(b, int(ran3(num_vertices))); do_not_optimize(a.bitfield); }
+    });
+
+    runner.add("BM_SolutionPoolInsertDuplicate/" + name, [=](BenchmarkState &state) {
+        // Offering covers the pool already holds, as the GA does every generation once its population has converged
+        Random ran3(42);
+        SolutionPool pool(16);
+        vector<Chromosome> covers;
+        for (int i=0; i < 16; ++i) {
+            covers.emplace_back( Chromosome::full_cover(num_vertices) );
+            covers.back().update_with_bit_flip(int(ran3(num_vertices)), 0);
+            covers.back().is_vc = true;
+            pool.insert(covers.back());
+        }
+        long i = 0;
+        while (state.keep_running()) { auto inserted = pool.insert(covers[i++ & 15]); do_not_optimize(inserted); }
+    });
+
+    // Solver cycles; the solvers print their parameters on initialization, which is not interesting here
+    runner.add("BM_GeneticAlgoCycle/" + name, [=](BenchmarkState &state) {
+        ostringstream sink; auto old_buffer = cout.rdbuf(sink.rdbuf());
+        GeneticAlgoSearch algorithm(filepath);
+        algorithm.init(100, 42);
+        cout.rdbuf(old_buffer);
+        while (state.keep_running()) algorithm.step(1);
+    });
+
+    runner.add("BM_IsingMCCycle/" + name, [=](BenchmarkState &state) {
+        ostringstream sink; auto old_buffer = cout.rdbuf(sink.rdbuf());
+        IsingMCAlgoSearch algorithm(filepath);
+        algorithm.init(1, 42);
+        algorithm.step(1);
+        cout.rdbuf(old_buffer);
+        while (state.keep_running()) algorithm.step(1);
+    });
+}
+
+int main(int argc, char** argv) {
+    auto options        = parse_options(argc, argv, 1);
+    auto data_dir       = option_string(options, "data-dir", "data");
+    auto min_time_ms    = option_double(options, "min-time-ms", 100);
+    auto filter         = option_string(options, "filter", "");
+
+    BenchmarkRunner runner;
+    for (const auto &filepath : list_graph_files(data_dir)) {
+        auto pos = filepath.find_last_of("/\\");
+        register_graph_benchmarks(runner, filepath.substr(pos + 1, filepath.size() - pos - 7), filepath);
+    }
+
+    // Synthetic graphs are written out to temporary METIS files so that parsing and the solvers can load them too
+    vector<string> temporary_files;
+    for (const auto &size : option_list(options, "synthetic-sizes", "1000,10000,100000")) {
+        auto filepath = "bench_synthetic_" + size + ".graph";
+        synthetic_graph(std::atoi(size.c_str()), 8, 42).write_to_file(filepath);
+        temporary_files.emplace_back(filepath);
+        register_graph_benchmarks(runner, "synthetic_" + size, filepath);
+    }
+
+    auto results = runner.run(min_time_ms, filter, cout);
+    for (const auto &filepath : temporary_files) std::remove(filepath.c_str());
+
+    if (options.count("json")) {
+        ofstream ofs(options.at("json"));
+        BenchmarkRunner::write_json(ofs, results);
+        cout << "\nResults written to '" << options.at("json") << "'" << endl;
+    }
+
+    // Compare against the results of an earlier run, e.g. from the previous commit
+    if (options.count("baseline")) {
+        map<string, double> baseline;
+        for (const auto &result : BenchmarkRunner::read_json(options.at("baseline"))) baseline[result.name] = result.ns_per_iteration;
+
+        cout << "\nComparison against '" << options.at("baseline") << "' (new time / old time):" << endl;
+        for (const auto &result : results) {
+            if (not baseline.count(result.name)) continue;
+            cout << "    " << result.name << ": " << (result.ns_per_iteration / baseline[result.name]) << endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * generateGraph.cpp
+ * Writes a random graph in METIS format, for scaling experiments beyond the graphs in data/.  For planted-cover
+ * graphs the optimal cover is written next to it as <output>.cover (size, then the 1-based vertex ids).
+ * Usage: ./generateGraph <model> <output_file_path> [--n=<vertices>] [--m=<edges>] [--attachment=<edges per vertex>]
+ *                        [--a=<p> --b=<p> --c=<p>] [--radius=<r>] [--cover=<size>] [--seed=<seed>] [--threads=<count>]
+ *        Models: erdos-renyi, barabasi-albert, rmat, geometric, planted-cover
+ */
+
+#include "GraphGenerator.h"
+#include "Stopwatch.h"
+#include "Utilities.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    if (argc < 3 or strncmp(argv[1], "--", 2) == 0 or strncmp(argv[2], "--", 2) == 0) {
+        cerr << "    Usage: " << argv[0] << " <model> <output_file_path> [options]\n"
+             << "    Models allowed: [ erdos-renyi, barabasi-albert, rmat, geometric, planted-cover ]\n"
+             << "    Options:\n"
+             << "        --n=<vertices>                 number of vertices (default: 1000)\n"
+             << "        --m=<edges>                    number of edges; for geometric graphs, the expected number (default: 4n)\n"
+             << "        --attachment=<edges>           barabasi-albert: edges added with each new vertex (default: 4)\n"
+             << "        --a=<p> --b=<p> --c=<p>        rmat: quadrant probabilities (default: 0.57, 0.19, 0.19)\n"
+             << "        --radius=<r>                   geometric: connection radius in the unit square (default: from --m)\n"
+             << "        --cover=<size>                 planted-cover: size of the planted optimal cover (default: n/4)\n"
+             << "        --seed=<seed>                  random seed; the graph does not depend on the thread count (default: 42)\n"
+             << "        --threads=<count>              threads used for generation (default: all cores)" << endl;
+        std::exit(-1);
+    }
+    auto options = parse_options(argc, argv, 3);
+
+    GeneratorParameters params;
+    params.model            = GeneratorParameters::parse_model(argv[1]);
+    params.num_vertices     = option_int(options, "n", params.num_vertices);
+    params.num_edges        = std::atol(option_string(options, "m", to_string(4L * params.num_vertices)).c_str());
+    params.attachment       = option_int(options, "attachment", params.attachment);
+    params.rmat_a           = option_double(options, "a", params.rmat_a);
+    params.rmat_b           = option_double(options, "b", params.rmat_b);
+    params.rmat_c           = option_double(options, "c", params.rmat_c);
+    params.radius           = option_double(options, "radius", params.radius);
+    params.cover_size       = option_int(options, "cover", params.cover_size);
+    params.rand_seed        = option_int(options, "seed", params.rand_seed);
+    params.num_threads      = option_int(options, "threads", params.num_threads);
+
+    Stopwatch stopwatch;
+    GraphGenerator generator(params);
+    auto file = generator.generate();
+    cout << "[ GRAPH GENERATOR ]: Generated a " << GeneratorParameters::model_name(params.model) << " graph with " << file.num_vertices()
+         << " vertices and " << file.num_edges() << " edges in " << (stopwatch.elapsed_ms() / 1000.0) << "s" << endl;
+
+    file.write_to_file(argv[2]);
+    cout << "[ GRAPH GENERATOR ]: Graph written to '" << argv[2] << "'" << endl;
+
+    if (params.model == GraphModel::PLANTED_COVER) {
+        auto cover_filepath = string(argv[2]) + ".cover";
+        ofstream ofs(cover_filepath.c_str(), ofstream::out);
+        ofs << generator.planted_cover().size() << "\n";
+        for (auto i=0U; i < generator.planted_cover().size(); ++i) ofs << (i ? "," : "") << generator.planted_cover()[i] + 1;
+        ofs << "\n";
+        cout << "[ GRAPH GENERATOR ]: Planted optimal cover of size " << generator.planted_cover().size() << " written to '" << cover_filepath << "'" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,239 @@
+/*
+ * runExperiments.cpp
+ * Runs a (graph x method x cutoff x seed) matrix of GA/ISING runs inside one process: every graph is parsed once and
+ * shared by all of its runs, and the runs are spread over a fixed pool of (pinned) threads, one run per thread at a
+ * time.  Traces and solutions go to the output directory as usual, together with a summary.csv of all runs and, for
+ * graphs whose optimal cover size is known, the QRTD/SQD/convergence/time-to-target CSVs of each (method, graph, cutoff).
+ * Usage: ./runExperiments [--data-dir=<dir>] [--graphs=<name1,name2,...>] [--methods=<GA,ISING>] [--cutoffs=<sec1,sec2,...>]
+ *                         [--seeds=<seed1,seed2,...>] [--threads=<count>] [--no-pin] [--output-dir=<dir>]
+ *                         [--optima=<name:size,...>] [--ttt-errors=<err1,err2,...>] [--ttt-percentiles=<p1,p2,...>]
+ *                         [--crossover=<single-point|uniform|subgraph|repairing>] [--local-search=<probes>]
+ *                         [--components=<size>] [--lp-reduction]
+ */
+
+#include "EdgeDenotedGraph.h"
+#include "GeneticAlgoSearch.h"
+#include "IsingMCAlgoSearch.h"
+#include "RunTimeDistribution.h"
+#include "ThreadPool.h"
+#include "Utilities.h"
+#include <sys/stat.h>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <streambuf>
+#include <tuple>
+
+using namespace std;
+
+// The same seeds runTests.py used
+const char *DEFAULT_SEEDS = "42,194,458,886,2356,986,224,1773,22,795";
+
+// Optimal (or best known) vertex cover sizes of the graphs in data/, from the table in runTests.py
+const map<string, int> KNOWN_OPTIMA = {
+    { "tiny", 4 }, { "karate", 14 }, { "football", 94 }, { "jazz", 158 }, { "email", 594 }, { "delaunay_n10", 703 },
+    { "netscience", 899 }, { "power", 2203 }, { "as-22july06", 3303 }, { "hep-th", 3926 }, { "star2", 4542 }, { "star", 6902 },
+};
+
+struct Job {
+    int     graph_idx;
+    string  method;
+    double  cutoff_time_sec;
+    int     rand_seed;
+
+    // Filled in once the run is over
+    int     cover_size          = 0;
+    double  time_to_best_sec    = 0;
+    int     num_improvements    = 0;
+    vector<TracePoint> trace;
+};
+
+// Swallows everything written to it; the solvers print their parameters on initialization, which would interleave, so
+// each run logs to a stream of its own over one of these
+class NullBuffer : public std::streambuf {
+  protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+};
+
+template <typename Algorithm>
+void record_result(Job &job, const Algorithm &algorithm) {
+    job.cover_size          = algorithm.best_solution().cover_weight;
+    job.num_improvements    = algorithm.trace().size();
+    job.time_to_best_sec    = algorithm.trace().empty() ? 0 : algorithm.trace().back().time_sec;
+    job.trace               = algorithm.trace();
+}
+
+void run_job(Job &job, const string &filepath, const GraphHandle &graph, const string &output_dir, CrossoverType crossover, int local_search_probes, int max_exact_component, bool lp_reduction) {
+    NullBuffer null_buffer;
+    std::ostream log(&null_buffer);
+    if (job.method == "GA") {
+        GeneticAlgoSearch algorithm(filepath, graph);
+        algorithm.set_log_stream(log);
+        algorithm.set_output_directory(output_dir);
+        algorithm.apply_reductions(lp_reduction, max_exact_component);
+        algorithm.set_crossover(crossover);
+        algorithm.set_local_search(local_search_probes);
+        algorithm.init(100, job.rand_seed);
+        algorithm.run_for_ms(job.cutoff_time_sec * 1000.0);
+        record_result(job, algorithm);
+    } else {
+        IsingMCAlgoSearch algorithm(filepath, graph);
+        algorithm.set_log_stream(log);
+        algorithm.set_output_directory(output_dir);
+        algorithm.apply_reductions(lp_reduction, max_exact_component);
+        algorithm.init(1, job.rand_seed);
+        algorithm.run_for_ms(job.cutoff_time_sec * 1000.0);
+        record_result(job, algorithm);
+    }
+}
+
+int main(int argc, char** argv) {
+    auto options        = parse_options(argc, argv, 1);
+    auto data_dir       = option_string(options, "data-dir", "data");
+    auto output_dir     = option_string(options, "output-dir", "experiments");
+    auto num_threads    = option_int(options, "threads", ThreadPool::hardware_threads());
+    auto crossover      = parse_crossover( option_string(options, "crossover", "single-point") );
+    auto local_search   = option_int(options, "local-search", 0);
+    auto components     = option_int(options, "components", 0);
+    auto lp_reduction   = options.count("lp-reduction") > 0;
+
+    // Graphs, either named explicitly or everything in the data directory
+    vector<string> filepaths;
+    if (options.count("graphs")) {
+        for (const auto &name : option_list(options, "graphs", "")) {
+            filepaths.emplace_back(join_path(data_dir, (name.find(".graph") == string::npos) ? name + ".graph" : name));
+        }
+    } else filepaths = list_graph_files(data_dir);
+
+    auto methods = option_list(options, "methods", "GA,ISING");
+    for (const auto &method : methods) {
+        if (method != "GA" and method != "ISING") {
+            cerr << "[runExperiments] Unknown method '" << method << "'; allowed methods are [ GA, ISING ]" << endl;
+            std::exit(-1);
+        }
+    }
+    if (filepaths.empty()) {
+        cerr << "[runExperiments] No graphs found in '" << data_dir << "'" << endl;
+        std::exit(-1);
+    }
+    mkdir(output_dir.c_str(), 0755);
+
+    auto optima = KNOWN_OPTIMA;
+    for (const auto &entry : option_list(options, "optima", "")) {
+        auto pos = entry.find(':');
+        if (pos == string::npos) {
+            cerr << "[runExperiments] Expected --optima=<name:size,...>, but got '" << entry << "'" << endl;
+            std::exit(-1);
+        } optima[entry.substr(0, pos)] = std::atoi(entry.c_str() + pos + 1);
+    }
+
+    ThreadPool pool(num_threads, not options.count("no-pin"));
+    // The solvers turn off stdio syncing (a global setting, which resets cout's buffer); do it here, not from the runs
+    std::ios_base::sync_with_stdio(false);
+
+    // Parse every graph exactly once, in parallel, without the edge ids the solvers never use.  Each parse runs on its
+    // own thread of the pool rather than starting a thread pool of its own
+    vector<GraphHandle> graphs(filepaths.size());
+    pool.parallel_for(filepaths.size(), [&](int graph_idx, int) {
+        graphs[graph_idx] = std::make_shared<EdgeDenotedGraph>( RawMetisFile::read(filepaths[graph_idx], GraphFormat::AUTO, 1), false );
+    });
+
+    // Every run keeps its own solution pool, so the runs stay independent of each other and of thread timing
+    vector<Job> jobs;
+    for (auto graph_idx=0U; graph_idx < filepaths.size(); ++graph_idx) {
+        for (const auto &method : methods) {
+            for (const auto &cutoff : option_list(options, "cutoffs", "10")) {
+                for (const auto &seed : option_list(options, "seeds", DEFAULT_SEEDS)) {
+                    Job job; job.graph_idx = graph_idx; job.method = method;
+                    job.cutoff_time_sec = std::atof(cutoff.c_str()); job.rand_seed = std::atoi(seed.c_str());
+                    jobs.emplace_back(job);
+                }
+            }
+        }
+    }
+
+    // Longest runs first, so the short ones fill in the gaps at the end instead of leaving threads idle
+    std::stable_sort(jobs.begin(), jobs.end(), [](const Job &a, const Job &b) { return a.cutoff_time_sec > b.cutoff_time_sec; });
+
+    cerr << "[runExperiments] " << jobs.size() << " runs over " << graphs.size() << " graphs on " << pool.num_threads() << " threads" << endl;
+    // Run-time distributions per (method, graph, cutoff), folded in as the runs finish
+    typedef tuple<string, string, double> GroupKey;
+    map<GroupKey, RunTimeDistribution> distributions;
+
+    std::mutex progress_mutex;
+    int num_finished = 0;
+    pool.parallel_for(jobs.size(), [&](int job_idx, int) {
+        auto &job = jobs[job_idx];
+        run_job(job, filepaths[job.graph_idx], graphs[job.graph_idx], output_dir, crossover, local_search, components, lp_reduction);
+
+        lock_guard<std::mutex> lock(progress_mutex);
+        auto name = graph_name(filepaths[job.graph_idx]);
+        if (optima.count(name)) {
+            auto key = make_tuple(job.method, name, job.cutoff_time_sec);
+            distributions.emplace(key, RunTimeDistribution(optima.at(name))).first->second.add_run(job.trace);
+        }
+        job.trace.clear(); job.trace.shrink_to_fit();
+
+        cerr << "[" << ++num_finished << "/" << jobs.size() << "] " << graph_name(filepaths[job.graph_idx]) << " " << job.method
+             << " cutoff=" << job.cutoff_time_sec << " seed=" << job.rand_seed << ": " << job.cover_size << endl;
+    });
+
+    // One row per run
+    auto summary_filepath = join_path(output_dir, "summary.csv");
+    ofstream summary(summary_filepath.c_str(), ofstream::out);
+    summary << "graph,method,cutoff_sec,seed,cover_size,time_to_best_sec,improvements\n";
+    for (const auto &job : jobs) {
+        summary << graph_name(filepaths[job.graph_idx]) << "," << job.method << "," << job.cutoff_time_sec << "," << job.rand_seed << ","
+                << job.cover_size << "," << job.time_to_best_sec << "," << job.num_improvements << "\n";
+    }
+
+    // One set of distribution CSVs per group, named as analysis.py named them (plus the cutoff if there are several)
+    auto num_cutoffs = option_list(options, "cutoffs", "10").size();
+    vector<double> ttt_errors, ttt_percentiles;
+    for (const auto &value : option_list(options, "ttt-errors", "0,0.01,0.02,0.05,0.1")) ttt_errors.emplace_back(std::atof(value.c_str()));
+    for (const auto &value : option_list(options, "ttt-percentiles", "10,25,50,75,90")) ttt_percentiles.emplace_back(std::atof(value.c_str()));
+
+    for (const auto &distribution : distributions) {
+        ostringstream suffix;
+        suffix << std::get<0>(distribution.first) << "_" << std::get<1>(distribution.first);
+        if (num_cutoffs > 1) suffix << "_" << std::get<2>(distribution.first);
+
+        ofstream qrtd(join_path(output_dir, "QRTD_" + suffix.str() + ".csv").c_str(), ofstream::out);
+        distribution.second.write_qrtd_csv(qrtd);
+        ofstream sqd(join_path(output_dir, "SQD_" + suffix.str() + ".csv").c_str(), ofstream::out);
+        distribution.second.write_sqd_csv(sqd);
+        ofstream convergence(join_path(output_dir, "CONVERGENCE_" + suffix.str() + ".csv").c_str(), ofstream::out);
+        distribution.second.write_convergence_csv(convergence);
+        ofstream ttt(join_path(output_dir, "TTT_" + suffix.str() + ".csv").c_str(), ofstream::out);
+        distribution.second.write_time_to_target_csv(ttt, ttt_errors, ttt_percentiles);
+    }
+
+    // And aggregated over seeds on screen
+    map<tuple<string, string, double>, vector<const Job*>> groups;
+    for (const auto &job : jobs) groups[make_tuple(graph_name(filepaths[job.graph_idx]), job.method, job.cutoff_time_sec)].emplace_back(&job);
+
+    cout << "\n" << std::left << std::setw(24) << "Graph" << std::setw(8) << "Method" << std::right << std::setw(10) << "Cutoff"
+         << std::setw(8) << "Runs" << std::setw(10) << "Min" << std::setw(10) << "Mean" << std::setw(10) << "Max" << std::setw(16) << "Time to best"
+         << "\n" << string(96, '-') << endl;
+    for (const auto &group : groups) {
+        int min_size = std::numeric_limits<int>::max(), max_size = 0; double total_size = 0, total_time = 0;
+        for (const auto *job : group.second) {
+            min_size = std::min(min_size, job->cover_size); max_size = std::max(max_size, job->cover_size);
+            total_size += job->cover_size; total_time += job->time_to_best_sec;
+        }
+        auto num_runs = group.second.size();
+        cout << std::left << std::setw(24) << std::get<0>(group.first) << std::setw(8) << std::get<1>(group.first) << std::right
+             << std::setw(10) << std::get<2>(group.first) << std::setw(8) << num_runs << std::setw(10) << min_size
+             << std::setw(10) << std::fixed << std::setprecision(1) << total_size / num_runs << std::setw(10) << max_size
+             << std::setw(16) << std::setprecision(3) << total_time / num_runs << std::defaultfloat << endl;
+    }
+    cout << "\nTraces, solutions and '" << summary_filepath << "' written to '" << output_dir << "'" << endl;
+    return 0;
+}
@@ -2,59 +2,291 @@
 #include "GeneticAlgoSearch.h"
 #include "IsingMCAlgoSearch.h"
 #include "BranchAndBound.h"
+#include "TreeDecomposition.h"
+#include "ComponentDecomposition.h"
+#include "CompressedGraph.h"
 #include "Stopwatch.h"
+#include "SolverEvents.h"
+#include <csignal>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 
 using namespace std;
 
-void run_genetic_algorithm(const string &filepath, double cutoff_time_sec, int rand_seed, bool verbose=false) {
+/*
+    Shared by all methods: SIGINT, SIGTERM and reaching --target cancel the run, which then stops and writes its best
+    cover as at the cutoff, and --stream reports every improvement as a line of JSON
+*/
+struct RunControl {
+    CancellationHandle                  cancellation    = std::make_shared<CancellationToken>();
+    std::unique_ptr<ImprovementStream>  stream;
+    int                                 target          = -1;
+    Improvement                         last            { "", 0, -1 };
+
+    void report(const Improvement &improvement) {
+        last = improvement;
+        if (stream) stream->write_improvement(improvement);
+        if (target >= 0 and improvement.cover_size <= target and not cancellation->cancelled()) {
+            cout << "[ RUN ]: Cover of size " << improvement.cover_size << " reached --target=" << target << "; stopping" << endl;
+            cancellation->cancel();
+        }
+    }
+
+    ImprovementCallback observer() {
+        return [this](const Improvement &improvement) { report(improvement); };
+    }
+
+    void finish(const string &solver, double elapsed_sec) {
+        if (stream) stream->write_finished({ solver, elapsed_sec, last.cover_size }, cancellation->cancelled());
+    }
+} control;
+
+void cancel_on_signal(int signal_number) {
+    // The first signal asks the solver to stop; phases that never check the token (loading, reductions, ...) can't,
+    // so the handler is reset and a second signal kills the process as usual
+    control.cancellation->cancel();
+    std::signal(signal_number, SIG_DFL);
+}
+
+template <typename Algorithm>
+std::unique_ptr<Algorithm> load_search(const string &filepath, const Options &options) {
+    // --compressed searches a CompressedGraph encoded straight from the file, for graphs too large for EdgeDenotedGraph
+    if (options.count("compressed")) return std::unique_ptr<Algorithm>( new Algorithm(filepath, std::make_shared<CompressedGraph>(filepath)) );
+    return std::unique_ptr<Algorithm>( new Algorithm(filepath) );
+}
+
+template <typename Algorithm>
+void write_statistics(const Options &options, const Algorithm &algorithm) {
+    // Dump the solver's counters and phase timers as JSON if asked to (they are compiled out of release builds)
+    if (not options.count("stats")) return;
+    std::ofstream ofs(options.at("stats").c_str(), std::ofstream::out);
+    algorithm.statistics().write_json(ofs);
+    cout << "Solver statistics written to '" << options.at("stats") << "'" << endl;
+}
+
+void run_genetic_algorithm(const string &filepath, double cutoff_time_sec, int rand_seed, const Options &options, bool verbose=false) {
     auto population_size        = 100;
-    GeneticAlgoSearch algorithm(filepath);
-    algorithm.init(population_size, rand_seed);
+    auto search = load_search<GeneticAlgoSearch>(filepath, options); auto &algorithm = *search;
+    if (options.count("resume")) algorithm.resume(options.at("resume"));
+    else {
+        algorithm.apply_reductions( options.count("lp-reduction") > 0, options.count("components") ? option_int(options, "components", 64) : 0 );
+        if (options.count("reorder")) algorithm.set_vertex_ordering( VertexMapping::parse_type(options.at("reorder")) );
+        if (options.count("crossover")) algorithm.set_crossover( parse_crossover(options.at("crossover")) );
+        if (options.count("local-search")) algorithm.set_local_search( option_int(options, "local-search", 0) );
+        if (options.count("pool-size")) algorithm.set_solution_pool( std::make_shared<SolutionPool>(option_int(options, "pool-size", 16)) );
+        algorithm.init(population_size, rand_seed);
+    }
+    if (options.count("checkpoint")) algorithm.set_checkpoint( options.at("checkpoint"), option_double(options, "checkpoint-interval", 300) );
+    algorithm.set_improvement_callback(control.observer());
+    algorithm.set_cancellation(control.cancellation);
     algorithm.run_for_ms(cutoff_time_sec*1000.0, verbose);
+    write_statistics(options, algorithm);
 }
 
-void run_ising_mc_algorithm(const string &filepath, double cutoff_time_sec, int rand_seed, bool verbose=false) {
-    IsingMCAlgoSearch algorithm(filepath);
-    algorithm.init(1, rand_seed);
+void run_ising_mc_algorithm(const string &filepath, double cutoff_time_sec, int rand_seed, const Options &options, bool verbose=false) {
+    AnnealingParameters schedule;
+    schedule.type                   = AnnealingParameters::parse_type( option_string(options, "schedule", "constant") );
+    schedule.initial_temperature    = option_double(options, "t0", schedule.initial_temperature);
+    schedule.final_temperature      = option_double(options, "tf", schedule.final_temperature);
+    schedule.target_acceptance      = option_double(options, "target-acceptance", schedule.target_acceptance);
+    schedule.reheat_after_ms        = option_double(options, "reheat-ms", schedule.reheat_after_ms);
+    schedule.reheat_fraction        = option_double(options, "reheat-fraction", schedule.reheat_fraction);
+
+    auto search = load_search<IsingMCAlgoSearch>(filepath, options); auto &algorithm = *search;
+    if (options.count("resume")) algorithm.resume(options.at("resume"));
+    else {
+        algorithm.apply_reductions( options.count("lp-reduction") > 0, options.count("components") ? option_int(options, "components", 64) : 0 );
+        if (options.count("reorder")) algorithm.set_vertex_ordering( VertexMapping::parse_type(options.at("reorder")) );
+        if (options.count("pool-size")) algorithm.set_solution_pool( std::make_shared<SolutionPool>(option_int(options, "pool-size", 16)) );
+        algorithm.init(option_int(options, "systems", 1), schedule, option_double(options, "A", 1), option_double(options, "B", 100), rand_seed);
+
+        algorithm.set_kernel( parse_kernel(option_string(options, "kernel", "metropolis")) );
+        algorithm.set_num_threads( option_int(options, "threads", 0) );
+    }
+    if (options.count("checkpoint")) algorithm.set_checkpoint( options.at("checkpoint"), option_double(options, "checkpoint-interval", 300) );
+    algorithm.set_improvement_callback(control.observer());
+    algorithm.set_cancellation(control.cancellation);
     algorithm.run_for_ms(cutoff_time_sec*1000.0, verbose);
+    write_statistics(options, algorithm);
 }
 
-void run_bb_algorithm(const string &filepath, double cutoff_time_sec, bool verbose=false) {
+void run_bb_algorithm(const string &filepath, double cutoff_time_sec, const Options &options, bool verbose=false) {
     BranchAndBound algorithm(filepath);
     algorithm.init(verbose, cutoff_time_sec);
+    algorithm.set_lp_bound(options.count("lp-bound") > 0);
+    algorithm.set_clique_bound(options.count("clique-bound") > 0);
+    if (options.count("checkpoint")) algorithm.set_checkpoint( options.at("checkpoint"), option_double(options, "checkpoint-interval", 300) );
+    if (options.count("resume")) algorithm.resume(options.at("resume"));
+    algorithm.set_improvement_callback(control.observer());
+    algorithm.set_cancellation(control.cancellation);
     algorithm.run();
+    write_statistics(options, algorithm);
+}
+
+void run_td_algorithm(const string &filepath, double cutoff_time_sec, const Options &options) {
+    // Exact DP over a tree decomposition; gives up (writing no solution) if the elimination width exceeds --max-width
+    Stopwatch stopwatch;
+    EdgeDenotedGraph graph(filepath, false);
+    if (graph.is_weighted()) cout << "[TD] The DP minimizes cover size; vertex weights are only used to report the cover's weight" << endl;
+    auto heuristic = TreeDecomposition::parse_heuristic( option_string(options, "elimination", "min-degree") );
+    auto max_width = option_int(options, "max-width", 20);
+    if (max_width < 0 or max_width > TreeDecomposition::MAX_WIDTH) {
+        cout << "[TD] --max-width must be between 0 and " << TreeDecomposition::MAX_WIDTH << " (the DP table of a bag has 2^width entries)" << endl;
+        std::exit(-1);
+    }
+
+    TreeDecomposition decomposition(graph, heuristic, max_width);
+    if (not decomposition.complete()) {
+        cout << "[TD] " << TreeDecomposition::heuristic_name(heuristic) << " elimination reached width " << decomposition.width()
+             << " > --max-width=" << max_width << "; no solution written" << endl; return;
+    }
+    cout << "[TD] " << TreeDecomposition::heuristic_name(heuristic) << " elimination width: " << decomposition.width() << endl;
+
+    TreeDecompositionSolver solver(graph, decomposition);
+    solver.set_cancellation(control.cancellation);
+    auto bitfield = solver.solve(cutoff_time_sec * 1000 - stopwatch.elapsed_ms());
+    if (bitfield.empty()) { cout << "[TD] Cutoff reached or cancelled before the DP finished; no solution written" << endl; return; }
+    auto elapsed_sec = stopwatch.elapsed_ms() / 1000;
+
+    Chromosome cover(bitfield);
+    cover.calculate_score(graph);
+    cout << "[TD] Cover size: " << cover.filled_bits << ", peak table memory: " << solver.peak_table_bytes()
+         << " bytes, decision bits: " << solver.decision_bytes() << " bytes, " << elapsed_sec << "s" << endl;
+
+    std::ofstream tracefile(generate_trace_filepath(filepath, "TD", cutoff_time_sec).c_str(), std::ofstream::out);
+    tracefile << elapsed_sec << "," << cover.cover_weight << endl;
+    cover.write_solution_to_file(generate_solution_filepath(filepath, "TD", cutoff_time_sec), graph.original_ids());
+    control.report({ "TD", elapsed_sec, cover.cover_weight });
+}
+
+void run_mis_algorithm(const string &filepath, double cutoff_time_sec) {
+    // Exact cover of every component: bitmask branch and reduce up to 64 vertices, maximum independent set above.  A
+    // search cut short by the cutoff still leaves a cover, just not a proven minimum one
+    Stopwatch stopwatch;
+    EdgeDenotedGraph graph(filepath, false);
+    if (graph.is_weighted()) cout << "[MIS] The search minimizes cover size; vertex weights are only used to report the cover's weight" << endl;
+    vector<int> bitfield(graph.num_vertices(), 0);
+    auto optimal = true;
+    for (const auto &component : graph.connected_components()) {
+        if (int(component.size()) > BitsetGraph::MAX_VERTICES) {
+            cout << "[MIS] A component of " << component.size() << " vertices is larger than the " << BitsetGraph::MAX_VERTICES
+                 << " the bitset search holds; no solution written" << endl; return;
+        }
+        vector<int> cover;
+        if (int(component.size()) <= BitmaskVertexCover::MAX_VERTICES) cover = BitmaskVertexCover(graph, component).solve();
+        else {
+            BitsetVertexCover search(graph, component);
+            search.set_cancellation(control.cancellation);
+            cover = search.solve(0, std::max(1.0, cutoff_time_sec * 1000 - stopwatch.elapsed_ms()));
+            optimal = optimal and search.complete();
+        }
+        for (const auto local_id : cover) bitfield[ component[local_id] ] = 1;
+    }
+    auto elapsed_sec = stopwatch.elapsed_ms() / 1000;
+
+    Chromosome cover(bitfield);
+    cover.calculate_score(graph);
+    cout << "[MIS] Cover size: " << cover.filled_bits << (optimal ? " (optimal), " : " (cutoff reached, not proven optimal), ") << elapsed_sec << "s" << endl;
+
+    std::ofstream tracefile(generate_trace_filepath(filepath, "MIS", cutoff_time_sec).c_str(), std::ofstream::out);
+    tracefile << elapsed_sec << "," << cover.cover_weight << endl;
+    cover.write_solution_to_file(generate_solution_filepath(filepath, "MIS", cutoff_time_sec), graph.original_ids());
+    control.report({ "MIS", elapsed_sec, cover.cover_weight });
 }
 
 int main(int argc, char** argv) {
-    if (argc == 4 && strcmp(argv[2], "BB") == 0) { }
-    else if (argc != 5) {
-        cerr << "    Usage: " << argv[0] << " <input_file_path> <method> <time_cutoff_sec> <rand_seed>\n"
-             << "    Methods allowed: [ GA, ISING, BB ]" << endl; std::exit(-1);
+    // Positional arguments come first; anything after them is a --key=value option
+    auto num_positional = 1;
+    while (num_positional < argc and strncmp(argv[num_positional], "--", 2) != 0) num_positional++;
+
+    if (num_positional == 4 && (strcmp(argv[2], "BB") == 0 || strcmp(argv[2], "TD") == 0 || strcmp(argv[2], "MIS") == 0)) { }
+    else if (num_positional != 5) {
+        cerr << "    Usage: " << argv[0] << " <input_file_path> <method> <time_cutoff_sec> <rand_seed> [options]\n"
+             << "    Methods allowed: [ GA, ISING, BB, TD, MIS ]\n"
+             << "    Options for all methods:\n"
+             << "        --stats=<path>                                     write solver counters and phase timers as JSON\n"
+             << "        --components=<size>                                GA/ISING: solve connected components of up to <size> (<= 8192) vertices\n"
+             << "                                                           exactly and search only the rest\n"
+             << "        --lp-reduction                                     GA/ISING: fix the vertices the LP relaxation sets to 0 or 1\n"
+             << "                                                           (Nemhauser-Trotter) and search only the rest\n"
+             << "        --pool-size=<count>                                GA/ISING: number of distinct best covers kept (default: 16)\n"
+             << "        --compressed                                       GA/ISING: search a varint-compressed graph, for graphs too large\n"
+             << "                                                           to load otherwise (no --reorder, reductions or colored/rejection-free kernels)\n"
+             << "        --checkpoint=<path>                                GA/ISING/BB: save the search state to <path> periodically\n"
+             << "        --checkpoint-interval=<sec>                        seconds between checkpoints (default: 300)\n"
+             << "        --resume=<path>                                    GA/ISING/BB: continue the search saved in a checkpoint, with its own\n"
+             << "                                                           parameters, towards the same time cutoff\n"
+             << "        --target=<size>                                    stop as soon as a cover of at most <size> vertices (of at most\n"
+             << "                                                           that total weight, on a weighted METIS graph) is found\n"
+             << "        --stream=<stdout|unix:path>                        write every improvement as a line of JSON to stdout, or to a\n"
+             << "                                                           Unix domain socket listening at <path>\n"
+             << "    GA options:\n"
+             << "        --crossover=<single-point|uniform|subgraph|repairing>\n"
+             << "                                                           tail swap, per-bit swap, BFS-region swap, or tail swap\n"
+             << "                                                           with greedy repair of uncovered edges (default: single-point)\n"
+             << "        --local-search=<probes>                            memetic mode: local search at this many random vertices of every\n"
+             << "                                                           chromosome each generation (default: 0, off)\n"
+             << "        --reorder=<none|bfs|rcm>                           relabel vertices so crossover points split the graph into regions (default: none)\n"
+             << "    BB options:\n"
+             << "        --lp-bound                                         also prune with the LP relaxation of the undecided vertices\n"
+             << "        --clique-bound                                     also prune with a greedy clique cover of the undecided vertices\n"
+             << "    TD options:\n"
+             << "        --elimination=<min-degree|min-fill>                elimination ordering heuristic (default: min-degree)\n"
+             << "        --max-width=<width>                                give up if the decomposition is wider than this (default: 20, at most 30)\n"
+             << "    ISING options:\n"
+             << "        --schedule=<constant|geometric|linear|adaptive>    annealing schedule (default: constant)\n"
+             << "        --t0=<temperature>                                 initial temperature (default: 1/3)\n"
+             << "        --tf=<temperature>                                 final temperature (default: 0.05)\n"
+             << "        --target-acceptance=<rate>                         initial acceptance rate aimed for by the adaptive schedule (default: 0.2)\n"
+             << "        --reheat-ms=<ms>                                   reheat after this long without improvement (default: never)\n"
+             << "        --reheat-fraction=<fraction>                       reheat to this fraction of t0 (default: 1)\n"
+             << "        --A=<weight> --B=<weight>                          vertex and uncovered-edge penalty weights (default: 1, 100)\n"
+             << "        --systems=<count>                                  number of independent systems (default: 1)\n"
+             << "        --kernel=<metropolis|sequential|checkerboard|rejection-free|colored>\n"
+             << "                                                           MC move kernel: random proposals, in-order sweeps, even/odd sweeps,\n"
+             << "                                                           the n-fold way, or parallel sweeps over color classes (default: metropolis)\n"
+             << "        --threads=<count>                                  threads used by the colored kernel (default: all cores)\n"
+             << "        --reorder=<none|bfs|rcm>                           relabel vertices so neighbours are stored together (default: none)" << endl; std::exit(-1);
     }
+    auto options = parse_options(argc, argv, num_positional);
 
     double cutoff_time_sec  = std::atof(argv[3]);
-    
-    int rand_seed;
-    if(argc > 4) {
+
+    int rand_seed           = 0;
+    if(num_positional > 4) {
         rand_seed           = std::atoi(argv[4]);
     }
 
+    Stopwatch stopwatch;
+    control.target = option_int(options, "target", -1);
+    if (options.count("stream")) control.stream.reset(new ImprovementStream(options.at("stream")));
+    std::signal(SIGINT, cancel_on_signal);
+    std::signal(SIGTERM, cancel_on_signal);
+
     if (strcmp(argv[2], "GA") == 0) {
         cout << "\n    Method 'GA' chosen\n" << endl;
-        run_genetic_algorithm(argv[1], cutoff_time_sec, rand_seed, false);
+        run_genetic_algorithm(argv[1], cutoff_time_sec, rand_seed, options, false);
 
     } else if (strcmp("ISING", argv[2]) == 0) {
         cout << "\n    Method 'ISING' chosen\n" << endl;
-        run_ising_mc_algorithm(argv[1], cutoff_time_sec, rand_seed, false);
+        run_ising_mc_algorithm(argv[1], cutoff_time_sec, rand_seed, options, false);
     } else if (strcmp("BB", argv[2]) == 0) {
         cout << "\n    Method 'BB' chosen\n" << endl;
-        run_bb_algorithm(argv[1], cutoff_time_sec, false);
+        run_bb_algorithm(argv[1], cutoff_time_sec, options, false);
+    } else if (strcmp("TD", argv[2]) == 0) {
+        cout << "\n    Method 'TD' chosen\n" << endl;
+        run_td_algorithm(argv[1], cutoff_time_sec, options);
+    } else if (strcmp("MIS", argv[2]) == 0) {
+        cout << "\n    Method 'MIS' chosen\n" << endl;
+        run_mis_algorithm(argv[1], cutoff_time_sec);
     } else {
         cout << "\n    Method '" << argv[2] << "' not implemented\n" << endl;
     }
 
+    control.finish(argv[2], stopwatch.elapsed_ms() / 1000);
     return 0;
 }
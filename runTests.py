@@ -6,8 +6,6 @@ from distutils.version import LooseVersion
 
 RANDOM_SEEDS = [ 42, 194, 458, 886, 2356, 986, 224, 1773, 22, 795, ]
 
-PROGRAM = 'runGA'
-
 def parse_args():
     parser = argparse.ArgumentParser(description='CI Hooks Curler')
     args = parser.parse_args()
@@ -25,16 +23,12 @@ def run_command(command, verbose=False):
     return out, err, process.returncode
 
 def run_algo(algo, GRAPHS):
+    # runExperiments loads each graph once and runs all seeds for it on a pinned thread pool
     for graph, opt, runtime in GRAPHS:
-        for seed in RANDOM_SEEDS:
-            command     = './{} data/{} {} {} {} &> /dev/null &'.format(PROGRAM, graph, algo, runtime, seed)
-            sol_file    = '{}_GA_{}_{}.sol'.format(graph.split('.')[0], runtime, seed)
-            trace_file  = '{}_GA_{}_{}.trace'.format(graph.split('.')[0], runtime, seed)
-            # print sol_file, trace_file
-            run_command(command)
-        while int(run_command('ps -ax | grep \'{}\' | wc -l'.format( './{} data/{} {}'.format(PROGRAM, graph, algo) ))[0].split()[0]) > 2:
-            print 'Running for {}...'.format(graph)
-            time.sleep(30)
+        command = './runExperiments --graphs={} --methods={} --cutoffs={} --seeds={} --output-dir=.'.format(
+            graph, algo, runtime, ','.join(str(seed) for seed in RANDOM_SEEDS))
+        print 'Running for {}...'.format(graph)
+        run_command(command)
         print 'done!'
 
 def run_ga():
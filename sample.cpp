@@ -4,6 +4,7 @@
 #include "GeneticAlgoSearch.h"
 
 #include <iostream>
+#include <cstring>
 #include <map>
 
 using namespace std;
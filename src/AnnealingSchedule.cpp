@@ -0,0 +1,133 @@
+/*
+AnnealingSchedule.cpp: This module contains the temperature schedules used by the Ising MC algorithm for simulated annealing.  Schedules are driven by the wall-clock budget given to run_for_ms, so the same schedule anneals fully whether the run lasts 500ms or 5 hours.
+*/
+#include "AnnealingSchedule.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+
+ScheduleType AnnealingParameters::parse_type(const string &name) {
+    if (name == "constant")     return ScheduleType::CONSTANT;
+    if (name == "geometric")    return ScheduleType::GEOMETRIC;
+    if (name == "linear")       return ScheduleType::LINEAR;
+    if (name == "adaptive")     return ScheduleType::ADAPTIVE;
+
+    cout << "[AnnealingSchedule] Unknown schedule '" << name << "'; expected one of [ constant, geometric, linear, adaptive ]\n";
+    std::exit(-1);
+}
+
+string AnnealingParameters::type_name(ScheduleType type) {
+    switch (type) {
+        case ScheduleType::CONSTANT:    return "constant";
+        case ScheduleType::GEOMETRIC:   return "geometric";
+        case ScheduleType::LINEAR:      return "linear";
+        case ScheduleType::ADAPTIVE:    return "adaptive";
+    } return "unknown";
+}
+
+AnnealingSchedule::AnnealingSchedule(const AnnealingParameters &params) {
+    _params = params;
+    _temperature = _segment_temperature = params.initial_temperature;
+}
+
+void AnnealingSchedule::start(double budget_ms) {
+    _budget_ms              = budget_ms;
+    _segment_start_ms       = 0;
+    _segment_temperature    = _params.initial_temperature;
+    _temperature            = _params.initial_temperature;
+    _last_improvement_ms    = 0;
+    _progress               = 0;
+    _proposals = _acceptances = 0;
+    _num_reheats = 0;
+}
+
+double AnnealingSchedule::progress(double elapsed_ms) const {
+    // Fraction of the current annealing segment that has elapsed; a reheat starts a new segment that ends with the budget
+    auto segment_length = _budget_ms - _segment_start_ms;
+    if (segment_length <= 0) return 1.0;
+    return std::min(1.0, std::max(0.0, (elapsed_ms - _segment_start_ms) / segment_length));
+}
+
+void AnnealingSchedule::update(double elapsed_ms) {
+    // Restart/reheat on stagnation: begin a new segment that re-anneals over whatever budget is left
+    if (_params.reheat_after_ms > 0 and elapsed_ms - _last_improvement_ms > _params.reheat_after_ms) {
+        _segment_start_ms       = elapsed_ms;
+        _segment_temperature    = _params.initial_temperature * _params.reheat_fraction;
+        _last_improvement_ms    = elapsed_ms;
+        _temperature            = std::max(_temperature, _segment_temperature);
+        _num_reheats++;
+    }
+
+    _progress = progress(elapsed_ms);
+    auto T0 = _segment_temperature, Tf = std::min(_params.final_temperature, T0);
+
+    switch (_params.type) {
+        case ScheduleType::CONSTANT:
+            _temperature = T0;
+            break;
+        case ScheduleType::GEOMETRIC:
+            // T(p) = T0 * (Tf/T0)^p
+            _temperature = T0 * std::pow(Tf / T0, _progress);
+            break;
+        case ScheduleType::LINEAR:
+            _temperature = T0 + (Tf - T0) * _progress;
+            break;
+        case ScheduleType::ADAPTIVE:
+            // Temperature is adjusted from the acceptance counts in record_move(); only keep it inside [Tf, T0]
+            _temperature = std::min(T0, std::max(Tf, _temperature));
+            break;
+    }
+}
+
+void AnnealingSchedule::adapt() {
+    /*
+        Steer the acceptance rate towards a target that decays linearly to zero over the segment, so the search is
+        allowed to wander early on and freezes by the time the budget runs out.
+    */
+    auto acceptance_rate    = _acceptances / _proposals;
+    auto target             = _params.target_acceptance * (1.0 - _progress);
+    auto T0 = _segment_temperature, Tf = std::min(_params.final_temperature, T0);
+
+    if (acceptance_rate > target)   _temperature /= _params.adaptation_factor;
+    else                            _temperature *= _params.adaptation_factor;
+    _temperature = std::min(T0, std::max(Tf, _temperature));
+    _proposals = _acceptances = 0;
+}
+
+void AnnealingSchedule::record_move(bool accepted) {
+    if (_params.type != ScheduleType::ADAPTIVE) return;
+    _proposals++;
+    if (accepted) _acceptances++;
+    if (_proposals >= _params.adaptation_window) adapt();
+}
+
+void AnnealingSchedule::record_moves(double proposals, double acceptances) {
+    // Used by kernels that stand one accepted move in for many proposals (see RejectionFreeKernel)
+    if (_params.type != ScheduleType::ADAPTIVE) return;
+    _proposals += proposals;
+    _acceptances += acceptances;
+    if (_proposals >= _params.adaptation_window) adapt();
+}
+
+void AnnealingSchedule::record_improvement(double elapsed_ms) {
+    _last_improvement_ms = elapsed_ms;
+}
+
+double AnnealingSchedule::temperature() const {
+    return _temperature;
+}
+
+double AnnealingSchedule::beta() const {
+    return 1.0 / _temperature;
+}
+
+int AnnealingSchedule::num_reheats() const {
+    return _num_reheats;
+}
+
+const AnnealingParameters& AnnealingSchedule::parameters() const {
+    return _params;
+}
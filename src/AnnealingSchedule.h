@@ -0,0 +1,51 @@
+#ifndef ANNEALING_SCHEDULE_H_
+#define ANNEALING_SCHEDULE_H_
+
+#include <string>
+
+enum class ScheduleType { CONSTANT, GEOMETRIC, LINEAR, ADAPTIVE };
+
+struct AnnealingParameters {
+    ScheduleType    type                    = ScheduleType::CONSTANT;
+    double          initial_temperature     = 1.0 / 3.0;
+    double          final_temperature       = 0.05;
+    double          target_acceptance       = 0.2;      // ADAPTIVE only: acceptance rate aimed for at the start of the run
+    double          adaptation_factor       = 1.05;     // ADAPTIVE only: multiplicative temperature step per window
+    int             adaptation_window       = 1000;     // ADAPTIVE only: number of proposals between adjustments
+    double          reheat_after_ms         = 0;        // reheat after this long without improvement (0 disables)
+    double          reheat_fraction         = 1.0;      // reheat to this fraction of the initial temperature
+
+    static ScheduleType parse_type(const std::string &name);
+    static std::string type_name(ScheduleType type);
+};
+
+class AnnealingSchedule {
+    AnnealingParameters _params;
+    double  _temperature            = 1.0 / 3.0;
+    double  _budget_ms              = 0;
+    double  _segment_start_ms       = 0;
+    double  _segment_temperature    = 1.0 / 3.0;
+    double  _last_improvement_ms    = 0;
+    double  _progress               = 0;
+    double  _proposals              = 0;
+    double  _acceptances            = 0;
+    int     _num_reheats            = 0;
+
+    double progress(double elapsed_ms) const;
+    void adapt();
+
+  public:
+    AnnealingSchedule() = default;
+    AnnealingSchedule(const AnnealingParameters &params);
+    void start(double budget_ms);
+    void update(double elapsed_ms);
+    void record_move(bool accepted);
+    void record_moves(double proposals, double acceptances);
+    void record_improvement(double elapsed_ms);
+    double temperature() const;
+    double beta() const;
+    int num_reheats() const;
+    const AnnealingParameters& parameters() const;
+};
+
+#endif
@@ -0,0 +1,125 @@
+/*
+Benchmark.cpp: a small microbenchmark harness (auto-scaled iteration counts, JSON output that can be diffed between commits)
+*/
+#include "Benchmark.h"
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+BenchmarkState::BenchmarkState(long iterations) {
+    _iterations = _remaining = iterations;
+}
+
+bool BenchmarkState::keep_running() {
+    // Start the clock on the first call, so any setup in the benchmark body before the loop is not timed
+    if (_remaining == _iterations) _stopwatch.reset();
+    return _remaining-- > 0;
+}
+
+long BenchmarkState::iterations() const {
+    return _iterations;
+}
+
+void BenchmarkState::pause_timing() {
+    _pause_stopwatch.reset();
+}
+
+void BenchmarkState::resume_timing() {
+    _paused_ms += _pause_stopwatch.elapsed_ms();
+}
+
+void BenchmarkState::set_items_processed(long long items) {
+    _items_processed = items;
+}
+
+long long BenchmarkState::items_processed() const {
+    return _items_processed;
+}
+
+double BenchmarkState::elapsed_ms() {
+    return _stopwatch.elapsed_ms() - _paused_ms;
+}
+
+void BenchmarkRunner::add(const string &name, const function<void(BenchmarkState&)> &body) {
+    benchmarks.emplace_back(name, body);
+}
+
+vector<BenchmarkResult> BenchmarkRunner::run(double min_time_ms, const string &filter, ostream &log) {
+    vector<BenchmarkResult> results;
+    auto old_flags = log.flags(); auto old_precision = log.precision();
+    log << std::left << std::setw(60) << "Benchmark" << std::right << std::setw(16) << "Time (ns)" << std::setw(14) << "Iterations" << std::setw(16) << "Items/s" << "\n"
+        << string(106, '-') << endl;
+
+    for (const auto &benchmark : benchmarks) {
+        if (not filter.empty() and benchmark.first.find(filter) == string::npos) continue;
+
+        // Grow the iteration count (at most 10x per round) until one run lasts at least min_time_ms
+        long iterations = 1; double elapsed_ms = 0;
+        while (true) {
+            BenchmarkState state(iterations);
+            benchmark.second(state);
+            elapsed_ms = state.elapsed_ms();
+
+            if (elapsed_ms >= min_time_ms or iterations >= 1000000000L) {
+                BenchmarkResult result;
+                result.name                 = benchmark.first;
+                result.iterations           = iterations;
+                result.ns_per_iteration     = elapsed_ms * 1e6 / iterations;
+                result.items_per_second     = (state.items_processed() > 0) ? state.items_processed() / (elapsed_ms / 1000.0) : 0;
+                results.emplace_back(result);
+                break;
+            }
+
+            auto multiplier = (elapsed_ms > 0) ? std::min(10.0, 1.4 * min_time_ms / elapsed_ms) : 10.0;
+            iterations = std::max(iterations + 1, long(iterations * multiplier));
+        }
+
+        const auto &result = results.back();
+        log << std::left << std::setw(60) << result.name << std::right << std::setw(16) << std::fixed << std::setprecision(1) << result.ns_per_iteration
+            << std::setw(14) << result.iterations << std::setw(16) << std::setprecision(0) << result.items_per_second << endl;
+    }
+
+    log.flags(old_flags); log.precision(old_precision);
+    return results;
+}
+
+void BenchmarkRunner::write_json(ostream &os, const vector<BenchmarkResult> &results) {
+    auto now = std::time(nullptr);
+    char date[64]; std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    os << "{\n  \"context\": {\n    \"date\": \"" << date << "\",\n"
+#ifdef NDEBUG
+       << "    \"build_type\": \"release\"\n"
+#else
+       << "    \"build_type\": \"debug\"\n"
+#endif
+       << "  },\n  \"benchmarks\": [";
+    for (auto i=0U; i < results.size(); ++i) {
+        os << ((i == 0) ? "\n" : ",\n")
+           << "    { \"name\": \"" << results[i].name << "\", \"iterations\": " << results[i].iterations
+           << ", \"ns_per_iteration\": " << std::setprecision(6) << results[i].ns_per_iteration
+           << ", \"items_per_second\": " << results[i].items_per_second << " }";
+    } os << "\n  ]\n}\n";
+}
+
+vector<BenchmarkResult> BenchmarkRunner::read_json(const string &filepath) {
+    // Only understands the format written by write_json: one benchmark object per line
+    vector<BenchmarkResult> results;
+    ifstream ifs(filepath);
+    string line;
+    while (std::getline(ifs, line)) {
+        auto name_pos = line.find("\"name\": \""), time_pos = line.find("\"ns_per_iteration\": ");
+        if (name_pos == string::npos or time_pos == string::npos) continue;
+
+        BenchmarkResult result;
+        name_pos += 9;
+        result.name = line.substr(name_pos, line.find('"', name_pos) - name_pos);
+        result.ns_per_iteration = std::atof(line.c_str() + time_pos + 20);
+        results.emplace_back(result);
+    } return results;
+}
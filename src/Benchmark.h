@@ -0,0 +1,60 @@
+#ifndef CSE6140_BENCHMARK_
+#define CSE6140_BENCHMARK_
+
+#include "Stopwatch.h"
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+    A small Google-Benchmark-style harness: each benchmark body loops `while (state.keep_running())`, and the runner
+    keeps increasing the iteration count until one run takes at least the minimum time.
+*/
+class BenchmarkState {
+    long        _iterations;
+    long        _remaining;
+    long long   _items_processed    = 0;
+    double      _paused_ms          = 0;
+    Stopwatch   _pause_stopwatch;
+    Stopwatch   _stopwatch;
+
+  public:
+    BenchmarkState(long iterations);
+    bool keep_running();
+    long iterations() const;
+    void pause_timing();
+    void resume_timing();
+    void set_items_processed(long long items);
+    long long items_processed() const;
+    double elapsed_ms();
+};
+
+struct BenchmarkResult {
+    std::string     name;
+    long            iterations          = 0;
+    double          ns_per_iteration    = 0;
+    double          items_per_second    = 0;
+};
+
+class BenchmarkRunner {
+    std::vector<std::pair<std::string, std::function<void(BenchmarkState&)>>> benchmarks;
+
+  public:
+    void add(const std::string &name, const std::function<void(BenchmarkState&)> &body);
+    std::vector<BenchmarkResult> run(double min_time_ms, const std::string &filter, std::ostream &log);
+    static void write_json(std::ostream &os, const std::vector<BenchmarkResult> &results);
+    static std::vector<BenchmarkResult> read_json(const std::string &filepath);
+};
+
+// Keeps the compiler from optimizing away a value computed only for benchmarking
+template <typename T>
+inline void do_not_optimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T *sink; sink = &value;
+#endif
+}
+
+#endif
@@ -0,0 +1,176 @@
+/*
+BitsetGraph.cpp: This module stores (sub)graphs as bitset adjacency matrices for word-parallel clique-cover bounds, and solves dense graphs exactly through a maximum independent set
+*/
+#include "BitsetGraph.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+
+namespace {
+    inline int popcount(uint64_t word) { return __builtin_popcountll(word); }
+    inline int lowest_bit(uint64_t word) { return __builtin_ctzll(word); }
+    inline uint64_t bit(int i) { return uint64_t(1) << (i & 63); }
+
+    int first_vertex(const vector<uint64_t> &set, int &word_idx) {
+        // Lowest local id in the set, starting the scan at word_idx, or -1 if the set is empty
+        for (; word_idx < int(set.size()); ++word_idx) {
+            if (set[word_idx]) return word_idx * 64 + lowest_bit(set[word_idx]);
+        } return -1;
+    }
+
+    vector<int> degree_order(const EdgeDenotedGraph &graph, const vector<int> &vertices) {
+        // Vertices of low degree first: they are in the most independent sets, so the first sets found are large
+        auto order = vertices;
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return graph.degree(a) < graph.degree(b); });
+        return order;
+    }
+}
+
+BitsetGraph::BitsetGraph(const EdgeDenotedGraph &graph, const vector<int> &vertices) {
+    // Local ids are positions in vertices; edges to vertices outside the list are ignored
+    if (int(vertices.size()) > MAX_VERTICES) {
+        cout << "[BitsetGraph] " << vertices.size() << " vertices is more than the " << MAX_VERTICES << " a bitset graph holds\n";
+        std::exit(-1);
+    }
+    _num_vertices = vertices.size();
+    _words = (_num_vertices + 63) / 64;
+    _rows.assign(size_t(_num_vertices) * _words, 0);
+
+    vector<int> local_ids(graph.num_vertices(), -1);
+    for (int i=0; i < _num_vertices; ++i) local_ids[ vertices[i] ] = i;
+    for (int i=0; i < _num_vertices; ++i) {
+        auto row = _rows.data() + size_t(i) * _words;
+        graph.for_each_neighbor(vertices[i], [&](int neighbor_idx) {
+            auto j = local_ids[neighbor_idx];
+            if (j >= 0 and j != i) row[j / 64] |= bit(j);
+        });
+    }
+}
+
+int BitsetGraph::num_vertices() const {
+    return _num_vertices;
+}
+
+int BitsetGraph::words() const {
+    return _words;
+}
+
+const uint64_t* BitsetGraph::row(int local_id) const {
+    return _rows.data() + size_t(local_id) * _words;
+}
+
+bool BitsetGraph::has_edge(int u, int v) const {
+    return row(u)[v / 64] & bit(v);
+}
+
+vector<uint64_t> BitsetGraph::all_vertices() const {
+    vector<uint64_t> set(_words, ~uint64_t(0));
+    if (_num_vertices % 64) set.back() = bit(_num_vertices) - 1;
+    return set;
+}
+
+int BitsetGraph::clique_cover_size(const vector<uint64_t> &subset) const {
+    // Each clique starts from the lowest remaining vertex and repeatedly adds the lowest vertex adjacent to all of it
+    auto remaining = subset;
+    vector<uint64_t> candidates(_words);
+    auto num_cliques = 0, start_word = 0;
+    for (int v; (v = first_vertex(remaining, start_word)) >= 0; ) {
+        num_cliques++;
+        candidates = remaining;
+        for (int word_idx = v / 64, u = v; u >= 0; u = first_vertex(candidates, word_idx)) {
+            remaining[u / 64] &= ~bit(u);
+            auto neighbors = row(u);
+            for (int w=word_idx; w < _words; ++w) candidates[w] &= neighbors[w];
+        }
+    } return num_cliques;
+}
+
+int BitsetGraph::clique_cover_bound(const vector<uint64_t> &subset) const {
+    auto size = 0;
+    for (const auto word : subset) size += popcount(word);
+    return size - clique_cover_size(subset);
+}
+
+BitsetVertexCover::BitsetVertexCover(const EdgeDenotedGraph &graph, const vector<int> &vertices)
+    : _graph(graph, degree_order(graph, vertices)) {
+    vector<int> positions(graph.num_vertices(), -1);
+    for (auto i=0U; i < vertices.size(); ++i) positions[ vertices[i] ] = i;
+    for (const auto v : degree_order(graph, vertices)) _order.emplace_back(positions[v]);
+}
+
+void BitsetVertexCover::expand(int depth) {
+    if ((_max_nodes > 0 and _num_nodes >= _max_nodes) or
+        (_num_nodes % 1024 == 0 and ((_max_ms > 0 and _stopwatch.elapsed_ms() > _max_ms) or is_cancelled(_cancellation)))) {
+        _complete = false; return;
+    }
+    _num_nodes++;
+    auto words = _graph.words();
+    auto &candidates = _candidates[depth];
+
+    // Color the candidates into cliques of the graph (independent sets of the complement); vertices are tried in
+    // reverse coloring order, so the one tried has as many colors as any independent set still reachable from it
+    vector<int> vertices, colors;
+    auto uncolored = candidates;
+    vector<uint64_t> clique(words);
+    auto color = 0, start_word = 0;
+    for (int v; (v = first_vertex(uncolored, start_word)) >= 0; ) {
+        color++;
+        clique = uncolored;
+        for (int word_idx = v / 64, u = v; u >= 0; u = first_vertex(clique, word_idx)) {
+            uncolored[u / 64] &= ~bit(u);
+            vertices.emplace_back(u); colors.emplace_back(color);
+            auto neighbors = _graph.row(u);
+            for (int w=word_idx; w < words; ++w) clique[w] &= neighbors[w];
+        }
+    }
+
+    for (auto i = int(vertices.size()) - 1; i >= 0; --i) {
+        if (int(_current.size()) + colors[i] <= int(_best.size())) return;
+        auto v = vertices[i];
+        candidates[v / 64] &= ~bit(v);
+
+        // The new candidates are the remaining ones not adjacent to v
+        auto &next = _candidates[depth + 1];
+        auto neighbors = _graph.row(v);
+        uint64_t any = 0;
+        for (int w=0; w < words; ++w) any |= (next[w] = candidates[w] & ~neighbors[w]);
+
+        _current.emplace_back(v);
+        if (any == 0) { if (_current.size() > _best.size()) _best = _current; }
+        else expand(depth + 1);
+        _current.pop_back();
+        if (not _complete) return;
+    }
+}
+
+void BitsetVertexCover::set_cancellation(CancellationHandle token) {
+    _cancellation = std::move(token);
+}
+
+vector<int> BitsetVertexCover::solve(long max_nodes, double max_ms) {
+    // Returns the local ids (positions in the vertex list) of a minimum cover: everything outside the independent set
+    _max_nodes = max_nodes; _max_ms = max_ms; _num_nodes = 0; _complete = true;
+    _stopwatch.reset();
+    _current.clear(); _best.clear();
+    // One candidate set per depth, allocated up front so the references held by the recursion stay valid
+    _candidates.assign(_graph.num_vertices() + 1, vector<uint64_t>(_graph.words()));
+    _candidates[0] = _graph.all_vertices();
+    if (_graph.num_vertices() > 0) expand(0);
+
+    vector<char> independent(_graph.num_vertices(), 0);
+    for (const auto v : _best) independent[v] = 1;
+    vector<int> cover;
+    for (int v=0; v < _graph.num_vertices(); ++v) if (not independent[v]) cover.emplace_back( _order[v] );
+    std::sort(cover.begin(), cover.end());
+    return cover;
+}
+
+long BitsetVertexCover::num_nodes() const {
+    return _num_nodes;
+}
+
+bool BitsetVertexCover::complete() const {
+    return _complete;
+}
@@ -0,0 +1,69 @@
+#ifndef CSE6140_BITSET_GRAPH_
+#define CSE6140_BITSET_GRAPH_
+
+#include "EdgeDenotedGraph.h"
+#include "Stopwatch.h"
+#include "SolverEvents.h"
+#include <cstdint>
+#include <vector>
+
+/*
+    Adjacency matrix of a (sub)graph of up to MAX_VERTICES vertices, one row of 64-bit words per vertex, so that set
+    operations on neighbourhoods are word-parallel ANDs and popcounts.  Vertex sets are bitsets of words() words over
+    the local ids (positions in the vertex list the graph was built from).
+
+    clique_cover_bound() covers a set greedily with cliques: every clique holds at most one vertex of an independent
+    set, so a set U has independence number at most the number of cliques k, and any vertex cover of the subgraph
+    induced by U has at least |U| - k vertices.  On dense graphs, where cliques are large, this is much stronger than
+    the matching bound.
+*/
+class BitsetGraph {
+    int                         _num_vertices   = 0;
+    int                         _words          = 0;
+    std::vector<std::uint64_t>  _rows;
+
+  public:
+    static const int MAX_VERTICES = 8192;
+
+    BitsetGraph(const EdgeDenotedGraph &graph, const std::vector<int> &vertices);
+    int num_vertices() const;
+    int words() const;
+    const std::uint64_t* row(int local_id) const;
+    bool has_edge(int u, int v) const;
+    std::vector<std::uint64_t> all_vertices() const;
+
+    int clique_cover_size(const std::vector<std::uint64_t> &subset) const;
+    int clique_cover_bound(const std::vector<std::uint64_t> &subset) const;
+};
+
+/*
+    Exact minimum vertex cover through a maximum independent set, i.e. a maximum clique of the complement graph,
+    found by bitset branch and bound (BBMC): candidates are greedily colored into cliques of the graph, and a branch
+    is cut as soon as the set so far plus the number of colors left cannot beat the best set.  Dense graphs have small
+    independent sets and large cliques, so the search stays small where the vertex cover branch and reduce struggles.
+    The search gives up after max_nodes nodes or max_ms milliseconds (0: never), or when cancelled; the cover returned
+    is then still a cover, the complement of the largest independent set found, but complete() is false.
+*/
+class BitsetVertexCover {
+    BitsetGraph                 _graph;
+    std::vector<int>            _order;         // local id -> position in the vertex list
+    std::vector<std::vector<std::uint64_t>> _candidates;
+    std::vector<int>            _current, _best;
+    long                        _num_nodes      = 0;
+    long                        _max_nodes      = 0;
+    double                      _max_ms         = 0;
+    Stopwatch                   _stopwatch;
+    CancellationHandle          _cancellation;
+    bool                        _complete       = true;
+
+    void expand(int depth);
+
+  public:
+    BitsetVertexCover(const EdgeDenotedGraph &graph, const std::vector<int> &vertices);
+    void set_cancellation(CancellationHandle token);
+    std::vector<int> solve(long max_nodes=0, double max_ms=0);
+    long num_nodes() const;
+    bool complete() const;
+};
+
+#endif
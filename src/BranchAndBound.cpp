@@ -2,6 +2,7 @@
 BranchAndBound.cpp: This module contains the routines for Branch and Bound.
 */
 #include "BranchAndBound.h"
+#include <algorithm>
 
 using namespace std;
 
@@ -24,20 +25,74 @@ void BranchAndBound::init(bool debug, int max_seconds)
     cout << "time limit  = " << max_seconds << "(s)" << endl;
 }
 
+// Prune with the LP relaxation of the undecided vertices (half the size of a maximum matching of the bipartite
+// double cover) in addition to the approximation bound
+void BranchAndBound::set_lp_bound(bool enabled)
+{
+    _use_lp_bound = enabled;
+    cout << "lp bound    = " << (enabled ? "on" : "off") << endl;
+}
+
+// Prune with a greedy cover of the undecided vertices by cliques: an independent set has at most one vertex in each,
+// so they need at least (number of vertices - number of cliques) cover vertices.  Much stronger than the LP bound on
+// dense graphs, but needs the adjacency matrix, so graphs of more than BitsetGraph::MAX_VERTICES vertices run without
+void BranchAndBound::set_clique_bound(bool enabled)
+{
+    _use_clique_bound = enabled;
+    cout << "clique bound = " << (enabled ? "on" : "off") << endl;
+}
+
+// Every interval_sec seconds, snapshot the search stacks and write them to path on a background thread
+void BranchAndBound::set_checkpoint(const string &path, double interval_sec)
+{
+    _checkpoint_writer.reset(new AsyncCheckpointWriter(path));
+    _checkpoint_interval_ms = std::max(0.0, interval_sec) * 1000.0;
+    cout << "checkpoint  = " << path << " every " << interval_sec << "(s)" << endl;
+}
+
+// Continue the search saved in a checkpoint by set_checkpoint instead of starting a new one
+void BranchAndBound::resume(const string &checkpoint_path)
+{
+    _resume_path = checkpoint_path;
+    cout << "resume from = " << checkpoint_path << endl;
+}
+
+// Called with every new best cover, as it is written to the trace file
+void BranchAndBound::set_improvement_callback(ImprovementCallback callback)
+{
+    _on_improvement = std::move(callback);
+}
+
+// Checked with the time limit at every node; a cancelled search stops as at the time limit
+void BranchAndBound::set_cancellation(CancellationHandle token)
+{
+    _cancellation = std::move(token);
+}
+
 // Begin running the algorithm
 void BranchAndBound::run()
 {
-    run_approximation();
+    {
+        SolverStats::ScopedPhase timer(_stats, Phase::BOUND);
+        run_approximation();
+    }
     _start_time = time(0);
+    SolverStats::ScopedPhase timer(_stats, Phase::SEARCH);
 	return start();
 }
 
-// Get bound approximation
+const SolverStats& BranchAndBound::statistics() const
+{
+    return _stats;
+}
+
+// Get bound approximation: the endpoints of a maximal matching, which form a cover (on a weighted graph, their weight)
 void BranchAndBound::run_approximation()
 {
     int node_idx = 0;
     int neighbor_idx;
     int iterations = 0;
+    long matched_weight = 0;
 
     while(_graph_approx.num_edges() > 0)
     {
@@ -58,11 +113,12 @@ void BranchAndBound::run_approximation()
                 _graph_approx.remove_edge(*edge_it);
             }
             iterations++;
+            matched_weight += _graph.vertex_weight(node_idx) + _graph.vertex_weight(neighbor_idx);
         }
         node_idx++;
     }
 
-    _approximation = iterations * 2;
+    _approximation = _graph.is_weighted() ? double(matched_weight) : iterations * 2;
     if(_debug)
     {
         cout << "_approximation: " << _approximation << ", nodes: " << _graph_approx.num_vertices() <<   endl;
@@ -73,29 +129,76 @@ void BranchAndBound::start()
 {
     _node_count = _graph.num_vertices();
     _current_best = std::numeric_limits<double>::infinity();
+    _covered_weight = 0;
 
-    // Get the first value to process
-    srand(time(0));
-    _current_node_idx = rand() % _node_count;
-    _starting_node_idx = _current_node_idx;
-
-    _node_states.push(std::tuple<int, bool, bool>(_current_node_idx, true, false));
+    // Both lower bounds count vertices, so they would overestimate a weighted cover
+    if(_graph.is_weighted() && (_use_lp_bound || _use_clique_bound))
+    {
+        cout << "LP and clique bounds disabled: not supported on weighted graphs" << endl;
+        _use_lp_bound = _use_clique_bound = false;
+    }
 
-    if(_debug)
+    if(_use_lp_bound)
     {
-        cout << "+ [node: " << _current_node_idx << ", cover: " << true << "]" << endl;
+        SolverStats::ScopedPhase timer(_stats, Phase::BOUND);
+        _lp.reset(new VertexCoverLP(_graph));
+        _lp->solve();
+        cout << "LP lower bound: " << _lp->lower_bound() << endl;
     }
 
-    _node_states.push(std::tuple<int, bool, bool>(_current_node_idx, false, false));
+    if(_use_clique_bound && _node_count > BitsetGraph::MAX_VERTICES)
+    {
+        cout << "Clique bound disabled: more than " << BitsetGraph::MAX_VERTICES << " vertices" << endl;
+    }
+    else if(_use_clique_bound)
+    {
+        SolverStats::ScopedPhase timer(_stats, Phase::BOUND);
+        std::vector<int> vertices(_node_count);
+        for(int i = 0; i < _node_count; i++)
+        {
+            vertices[i] = i;
+        }
+        _bitset_graph.reset(new BitsetGraph(_graph, vertices));
+        _undecided = _bitset_graph->all_vertices();
+        cout << "Clique cover lower bound: " << _bitset_graph->clique_cover_bound(_undecided) << endl;
+    }
 
-    if(_debug)
+    if(!_resume_path.empty())
     {
-        cout << "+ [node: " << _current_node_idx << ", cover: " << false << "]" << endl;
+        restore_checkpoint();
     }
+    else
+    {
+        // Get the first value to process
+        srand(time(0));
+        _current_node_idx = rand() % _node_count;
+        _starting_node_idx = _current_node_idx;
+
+        _node_states.push(std::tuple<int, bool, bool>(_current_node_idx, true, false));
+
+        if(_debug)
+        {
+            cout << "+ [node: " << _current_node_idx << ", cover: " << true << "]" << endl;
+        }
+
+        _node_states.push(std::tuple<int, bool, bool>(_current_node_idx, false, false));
+
+        if(_debug)
+        {
+            cout << "+ [node: " << _current_node_idx << ", cover: " << false << "]" << endl;
+        }
+    }
+    _since_checkpoint.reset();
 
     // Process each node state on the queue
     while(!_node_states.empty() && check_time())
     {
+        if(_checkpoint_writer && _since_checkpoint.elapsed_ms() >= _checkpoint_interval_ms)
+        {
+            write_checkpoint();
+            _since_checkpoint.reset();
+        }
+
         // check out the current top node
         _current_node_state = _node_states.top();
         _current_node_idx = std::get<0>(_current_node_state);
@@ -109,13 +212,23 @@ void BranchAndBound::start()
         // we are backtracking to this node; no further computation necessary
         if(std::get<2>(_current_node_state))
         {
+            _stats.count(Counter::NODES_BACKTRACKED);
             pop_current_node_state();
             continue;
         }
+        _stats.count(Counter::NODES_EXPANDED);
 
         // set the current node state as processed
         std::get<2>(_current_node_state) = true;
         _node_states.top() = _current_node_state;
+        if(_lp)
+        {
+            _lp->deactivate(_current_node_idx);
+        }
+        if(_bitset_graph)
+        {
+            _undecided[_current_node_idx / 64] &= ~(uint64_t(1) << (_current_node_idx % 64));
+        }
 
         // -------- Bound -------------
 
@@ -123,6 +236,7 @@ void BranchAndBound::start()
         if(std::get<1>(_current_node_state))
         {
             process_covered_state();
+            _covered_weight += _graph.vertex_weight(_current_node_idx);
         }
 
         // Handle the uncovered node state
@@ -143,13 +257,17 @@ void BranchAndBound::start()
             unprocessed = _starting_node_idx - _current_node_idx - 1;
         }
 
+        // size (or weight) of the cover so far
+        double cover_cost = _graph.is_weighted() ? double(_covered_weight) : double(_node_count - _nodes_uncovered.size() - unprocessed);
+
         // check whether all necessary nodes are covered
         if(_graph.num_edges() == 0)
         {
-            if(_current_best > (_node_count - _nodes_uncovered.size() - unprocessed))
+            if(_current_best > cover_cost)
             {
-                _current_best = _node_count - _nodes_uncovered.size() - unprocessed;
+                _current_best = cover_cost;
                 log_new_best(_current_best);
+                _stats.count(Counter::SOLUTIONS_FOUND);
                 cout << "! new best: " << _current_best << endl;
             }
             pop_current_node_state();
@@ -157,15 +275,32 @@ void BranchAndBound::start()
         }
 
         // already worse than current best solution
-        if(_node_count - _nodes_uncovered.size() - unprocessed > _current_best)
+        if(cover_cost > _current_best)
         {
+            _stats.count(Counter::NODES_PRUNED_BY_BEST);
             pop_current_node_state();
             continue;
         }
 
         // worse than (dynamically calculated) upper bound
-        if(_node_count - _nodes_uncovered.size() - unprocessed > _approximation)
+        if(cover_cost > _approximation)
         {
+            _stats.count(Counter::NODES_PRUNED_BY_APPROXIMATION);
+            pop_current_node_state();
+            continue;
+        }
+
+        // the undecided vertices need at least the LP bound to cover the edges among them
+        if(_lp && cover_cost + _lp->lower_bound() >= _current_best)
+        {
+            _stats.count(Counter::NODES_PRUNED_BY_LP_BOUND);
+            pop_current_node_state();
+            continue;
+        }
+
+        if(_bitset_graph && cover_cost + _bitset_graph->clique_cover_bound(_undecided) >= _current_best)
+        {
+            _stats.count(Counter::NODES_PRUNED_BY_CLIQUE_BOUND);
             pop_current_node_state();
             continue;
         }
@@ -219,6 +354,91 @@ void BranchAndBound::start()
     }
 }
 
+void BranchAndBound::write_checkpoint()
+{
+    CheckpointWriter checkpoint("BB");
+    checkpoint.put(_node_count);
+    checkpoint.put(_graph.num_edges() + long(_edges_removed.size()));
+    checkpoint.put(difftime(time(0), _start_time));
+    checkpoint.put(_current_best);
+    checkpoint.put(_starting_node_idx);
+
+    // Stacks bottom to top
+    std::vector<int> node_ids, edges_removed;
+    std::vector<char> node_covers, node_processed;
+    for(auto node_states = _node_states; !node_states.empty(); node_states.pop())
+    {
+        node_ids.push_back(std::get<0>(node_states.top()));
+        node_covers.push_back(std::get<1>(node_states.top()));
+        node_processed.push_back(std::get<2>(node_states.top()));
+    }
+    std::reverse(node_ids.begin(), node_ids.end());
+    std::reverse(node_covers.begin(), node_covers.end());
+    std::reverse(node_processed.begin(), node_processed.end());
+    for(auto removed = _edges_removed; !removed.empty(); removed.pop())
+    {
+        edges_removed.push_back(std::get<2>(removed.top()));
+        edges_removed.push_back(std::get<1>(removed.top()));
+        edges_removed.push_back(std::get<0>(removed.top()));
+    }
+    std::reverse(edges_removed.begin(), edges_removed.end());
+
+    checkpoint.put_vector(node_ids);
+    checkpoint.put_vector(node_covers);
+    checkpoint.put_vector(node_processed);
+    checkpoint.put_vector(edges_removed);
+    checkpoint.put_vector(std::vector<int>(_nodes_uncovered.begin(), _nodes_uncovered.end()));
+    _checkpoint_writer->submit(std::move(checkpoint));
+}
+
+void BranchAndBound::restore_checkpoint()
+{
+    CheckpointReader checkpoint(_resume_path, "BB");
+    checkpoint.check(checkpoint.get<int>() == _node_count && checkpoint.get<long>() == _graph.num_edges(), "was written for a different graph");
+    _start_time = time(0) - time_t(checkpoint.get<double>());
+    _current_best = checkpoint.get<double>();
+    _starting_node_idx = checkpoint.get<int>();
+
+    auto node_ids = checkpoint.get_vector<int>();
+    auto node_covers = checkpoint.get_vector<char>();
+    auto node_processed = checkpoint.get_vector<char>();
+    auto edges_removed = checkpoint.get_vector<int>();
+    auto nodes_uncovered = checkpoint.get_vector<int>();
+    checkpoint.check(node_covers.size() == node_ids.size() && node_processed.size() == node_ids.size() && edges_removed.size() % 3 == 0, "is malformed");
+
+    // The vertices of processed states are the ones decided so far: deactivate them in the bounds, as on expansion
+    for(auto i = 0U; i < node_ids.size(); i++)
+    {
+        _node_states.push(std::tuple<int, bool, bool>(node_ids[i], node_covers[i] != 0, node_processed[i] != 0));
+        if(!node_processed[i])
+        {
+            continue;
+        }
+        if(node_covers[i])
+        {
+            _covered_weight += _graph.vertex_weight(node_ids[i]);
+        }
+        if(_lp)
+        {
+            _lp->deactivate(node_ids[i]);
+        }
+        if(_bitset_graph)
+        {
+            _undecided[node_ids[i] / 64] &= ~(uint64_t(1) << (node_ids[i] % 64));
+        }
+    }
+
+    // Remove the edges again, in the order they were removed
+    for(auto i = 0U; i < edges_removed.size(); i += 3)
+    {
+        _edges_removed.push(std::tuple<int, int, int>(edges_removed[i], edges_removed[i+1], edges_removed[i+2]));
+        _graph.remove_edge(edges_removed[i+2]);
+    }
+    _nodes_uncovered.insert(nodes_uncovered.begin(), nodes_uncovered.end());
+
+    cout << "Resumed after " << difftime(time(0), _start_time) << "s with " << _node_states.size() << " node states; best: " << _current_best << endl;
+}
+
 void BranchAndBound::log_new_best(int value)
 {
     std::ostringstream oss;
@@ -229,6 +449,10 @@ void BranchAndBound::log_new_best(int value)
     output_file << difftime(time(0), _start_time) << ", " << value << "\n";
     output_file.close();
     log_new_solution(value);
+    if(_on_improvement)
+    {
+        _on_improvement({ "BB", difftime(time(0), _start_time), value });
+    }
 }
 
 void BranchAndBound::log_new_solution(int value)
@@ -240,8 +464,10 @@ void BranchAndBound::log_new_solution(int value)
     output_file.open(oss.str(), fstream::out);
     output_file << value << "\n";
 
+    // The decided nodes run cyclically from the starting node to the current one
     int index_idx = _starting_node_idx;
-    while(index_idx != (_current_node_idx+1))
+    int num_decided = (_current_node_idx - _starting_node_idx + _node_count) % _node_count + 1;
+    for(int k = 0; k < num_decided; k++)
     {
         std::set<int>::iterator it_uncovered = _nodes_uncovered.find(index_idx);
 
@@ -265,7 +491,7 @@ void BranchAndBound::split_filename()
 
 bool BranchAndBound::check_time()
 {
-    if(difftime(time(0), _start_time) > _max_seconds)
+    if(difftime(time(0), _start_time) > _max_seconds || is_cancelled(_cancellation))
     {
         return false;
     }
@@ -296,6 +522,19 @@ void BranchAndBound::pop_current_node_state()
     {
         _nodes_uncovered.erase(std::get<0>(_current_node_state));
     }
+    else
+    {
+        _covered_weight -= _graph.vertex_weight(std::get<0>(_current_node_state));
+    }
+
+    if(_lp)
+    {
+        _lp->activate(std::get<0>(_current_node_state));
+    }
+    if(_bitset_graph)
+    {
+        _undecided[std::get<0>(_current_node_state) / 64] |= uint64_t(1) << (std::get<0>(_current_node_state) % 64);
+    }
 
     // add any edges we removed during processing
     std::tuple<int, int, int> edge_info;
@@ -310,6 +549,7 @@ void BranchAndBound::pop_current_node_state()
         }
         _graph.add_edge(std::get<2>(edge_info), std::pair<int,int>(std::get<0>(edge_info), std::get<1>(edge_info)));
         _edges_removed.pop();
+        _stats.count(Counter::EDGES_RESTORED);
     }
 }
 
@@ -328,6 +568,7 @@ void BranchAndBound::process_covered_state()
         std::tuple<int,int,int> edge_removed(std::get<0>(_current_node_state), neighbor_idx, *edge_it);
         _edges_removed.push(edge_removed);
         _graph.remove_edge(*edge_it);
+        _stats.count(Counter::EDGES_REMOVED);
 
         if(_debug)
         {
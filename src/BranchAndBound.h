@@ -2,6 +2,12 @@
 #define BRANCH_AND_BOUND_H
 
 #include "EdgeDenotedGraph.h"
+#include "SolverStats.h"
+#include "Stopwatch.h"
+#include "VertexCoverLP.h"
+#include "BitsetGraph.h"
+#include "Checkpoint.h"
+#include "SolverEvents.h"
 #include <iostream>
 #include <vector>
 #include <map>
@@ -15,6 +21,7 @@
 #include <sstream>
 #include <string>
 #include <cstddef>
+#include <memory>
 
 class BranchAndBound 
 {
@@ -32,7 +39,31 @@ private:
     time_t _start_time;
     int _max_seconds;
     double _approximation; 
+    
+    // Weight of the vertices in the cover so far, on a weighted graph (unweighted, it is the number of covered nodes)
+    long _covered_weight = 0;
     int _starting_node_idx;
+    SolverStats _stats { "BB" };
+
+    // LP relaxation over the vertices not decided yet, kept up to date as the search descends and backtracks
+    bool _use_lp_bound = false;
+    std::unique_ptr<VertexCoverLP> _lp;
+
+    // Adjacency matrix and the set of undecided vertices, for the clique-cover bound on dense graphs
+    bool _use_clique_bound = false;
+    std::unique_ptr<BitsetGraph> _bitset_graph;
+    std::vector<uint64_t> _undecided;
+    
+    // Observer of new best covers, and the token that stops the search early
+    ImprovementCallback _on_improvement;
+    CancellationHandle _cancellation;
+    
+    // Periodic checkpoints of the search (the stacks below, the uncovered set and the best cover), and a checkpoint
+    // to resume from instead of starting over
+    std::unique_ptr<AsyncCheckpointWriter> _checkpoint_writer;
+    double _checkpoint_interval_ms = 0;
+    Stopwatch _since_checkpoint;
+    std::string _resume_path;
     
     // int - node id
     // bool - whether to cover (true) or uncover (false)
@@ -63,6 +94,9 @@ private:
     bool check_time();
 	void start();
 	
+    void write_checkpoint();
+    void restore_checkpoint();
+    
     void log_new_best(int value);
     void log_new_solution(int value);
     
@@ -77,7 +111,14 @@ public:
 	BranchAndBound() = delete;
 	BranchAndBound(const std::string &fileName);
 	void init(bool debug, int max_seconds);
+    void set_lp_bound(bool enabled);
+    void set_clique_bound(bool enabled);
+    void set_checkpoint(const std::string &path, double interval_sec);
+    void resume(const std::string &checkpoint_path);
+    void set_improvement_callback(ImprovementCallback callback);
+    void set_cancellation(CancellationHandle token);
 	void run();
+    const SolverStats& statistics() const;
 };
 
 #endif
@@ -0,0 +1,197 @@
+/*
+Checkpoint.cpp: This module serializes solver state into compact binary checkpoints, writes them on a background thread, and reads them back for resuming a run
+*/
+#include "Checkpoint.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+    const uint32_t CHECKPOINT_MAGIC     = 0x4B434643;   // "CFCK"
+    const uint32_t CHECKPOINT_VERSION   = 4;
+}
+
+CheckpointWriter::CheckpointWriter(const string &solver) {
+    put(CHECKPOINT_MAGIC);
+    put(CHECKPOINT_VERSION);
+    put_string(solver);
+}
+
+void CheckpointWriter::put_string(const string &value) {
+    put(uint64_t(value.size()));
+    _bytes.append(value);
+}
+
+void CheckpointWriter::put_bitfield(const vector<int> &bitfield) {
+    vector<uint64_t> bits((bitfield.size() + 63) / 64, 0);
+    for (auto i=0U; i < bitfield.size(); ++i) if (bitfield[i] != 0) bits[i / 64] |= uint64_t(1) << (i % 64);
+    put(uint64_t(bitfield.size()));
+    put_vector(bits);
+}
+
+void CheckpointWriter::put_chromosome(const Chromosome &chromosome) {
+    put_bitfield(chromosome.bitfield);
+    put(chromosome.is_vc); put(chromosome.score); put(chromosome.filled_bits); put(chromosome.cover_weight); put(chromosome.uncovered_edges); put(chromosome.hash);
+}
+
+void CheckpointWriter::put_random(const Random &random) {
+    put_string(random.state());
+}
+
+void CheckpointWriter::put_mapping(const VertexMapping &mapping) {
+    put_vector(mapping.original_ids); put_vector(mapping.new_ids); put_vector(mapping.fixed_cover); put_vector(mapping.input_ids);
+}
+
+void CheckpointWriter::put_trace(const vector<TracePoint> &trace) {
+    put_vector(trace);
+}
+
+string& CheckpointWriter::bytes() {
+    return _bytes;
+}
+
+CheckpointReader::CheckpointReader(const string &path, const string &solver) : _path(path) {
+    std::ifstream ifs(path.c_str(), std::ifstream::in | std::ifstream::binary);
+    check(ifs.good(), "cannot be opened");
+    _bytes.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+
+    check(get<uint32_t>() == CHECKPOINT_MAGIC, "is not a checkpoint file");
+    check(get<uint32_t>() == CHECKPOINT_VERSION, "was written by a different version of the program");
+    auto written_by = get_string();
+    check(written_by == solver, "was written by " + written_by + ", not " + solver);
+}
+
+void CheckpointReader::require(size_t num_bytes) {
+    check(num_bytes <= _bytes.size() - _position, "is truncated");
+}
+
+void CheckpointReader::check(bool condition, const string &message) const {
+    if (condition) return;
+    cout << "[Checkpoint] Checkpoint '" << _path << "' " << message << endl;
+    std::exit(-1);
+}
+
+string CheckpointReader::get_string() {
+    auto size = get<uint64_t>();
+    require(size);
+    auto value = _bytes.substr(_position, size);
+    _position += size;
+    return value;
+}
+
+vector<int> CheckpointReader::get_bitfield() {
+    auto size = get<uint64_t>();
+    auto bits = get_vector<uint64_t>();
+    check(bits.size() == (size + 63) / 64, "has a malformed bitfield");
+    vector<int> bitfield(size, 0);
+    for (auto i=0U; i < size; ++i) bitfield[i] = (bits[i / 64] >> (i % 64)) & 1;
+    return bitfield;
+}
+
+Chromosome CheckpointReader::get_chromosome() {
+    Chromosome chromosome;
+    chromosome.bitfield         = get_bitfield();
+    chromosome.is_vc            = get<bool>();
+    chromosome.score            = get<double>();
+    chromosome.filled_bits      = get<int>();
+    chromosome.cover_weight     = get<int>();
+    chromosome.uncovered_edges  = get<long>();
+    chromosome.hash             = get<uint64_t>();
+    return chromosome;
+}
+
+Random CheckpointReader::get_random() {
+    Random random;
+    random.set_state(get_string());
+    return random;
+}
+
+VertexMapping CheckpointReader::get_mapping() {
+    VertexMapping mapping;
+    mapping.original_ids    = get_vector<int>();
+    mapping.new_ids         = get_vector<int>();
+    mapping.fixed_cover     = get_vector<int>();
+    mapping.input_ids       = get_vector<long>();
+    return mapping;
+}
+
+vector<TracePoint> CheckpointReader::get_trace() {
+    return get_vector<TracePoint>();
+}
+
+AsyncCheckpointWriter::AsyncCheckpointWriter(const string &path) : _path(path) {
+    _thread = std::thread(&AsyncCheckpointWriter::write_loop, this);
+}
+
+AsyncCheckpointWriter::~AsyncCheckpointWriter() {
+    {
+        lock_guard<mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _condition.notify_all();
+    _thread.join();
+}
+
+void AsyncCheckpointWriter::submit(CheckpointWriter &&checkpoint) {
+    {
+        lock_guard<mutex> lock(_mutex);
+        _pending.swap(checkpoint.bytes());
+        _has_pending = true;
+    }
+    _condition.notify_all();
+}
+
+void AsyncCheckpointWriter::flush() {
+    // Blocks until the last checkpoint submitted is on disk
+    unique_lock<mutex> lock(_mutex);
+    _condition.wait(lock, [this] { return not _has_pending; });
+}
+
+void AsyncCheckpointWriter::write_loop() {
+    unique_lock<mutex> lock(_mutex);
+    while (true) {
+        _condition.wait(lock, [this] { return _has_pending or _stopping; });
+        if (not _has_pending) return;
+
+        // Write outside the lock, so the search can hand over the next checkpoint meanwhile
+        string bytes; bytes.swap(_pending);
+        lock.unlock();
+        // The temporary file must be complete and on disk before it replaces the last good checkpoint; a failed write
+        // (e.g. a full disk) leaves that checkpoint in place
+        auto temporary_path = _path + ".tmp";
+        auto written = false;
+        if (auto out = std::fopen(temporary_path.c_str(), "wb")) {
+            written = std::fwrite(bytes.data(), 1, bytes.size(), out) == bytes.size() and std::fflush(out) == 0;
+#if defined(__unix__) || defined(__APPLE__)
+            written = written and fsync(fileno(out)) == 0;
+#endif
+            written = (std::fclose(out) == 0) and written;
+        }
+        auto renamed = written and std::rename(temporary_path.c_str(), _path.c_str()) == 0;
+        if (not written) {
+            cout << "[Checkpoint] Failed to write '" << temporary_path << "'; keeping the previous checkpoint" << endl;
+            std::remove(temporary_path.c_str());
+        } else if (not renamed) cout << "[Checkpoint] Failed to rename '" << temporary_path << "' to '" << _path << "'" << endl;
+        lock.lock();
+
+        if (renamed) _num_written++;
+        if (_pending.empty()) _has_pending = false;
+        _condition.notify_all();
+    }
+}
+
+long AsyncCheckpointWriter::num_written() {
+    lock_guard<mutex> lock(_mutex);
+    return _num_written;
+}
+
+const string& AsyncCheckpointWriter::path() const {
+    return _path;
+}
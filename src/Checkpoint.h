@@ -0,0 +1,121 @@
+#ifndef CSE6140_CHECKPOINT_
+#define CSE6140_CHECKPOINT_
+
+#include "Chromosome.h"
+#include "Random.h"
+#include "Utilities.h"
+#include "VertexOrdering.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+    Binary checkpoints of solver state, for resuming long runs after the process dies.  A checkpoint is a header (magic
+    number, format version, solver name) followed by whatever the solver writes, in native byte order: checkpoints are
+    meant to be resumed on the machine that wrote them.  Bitfields are packed 64 bits to a word, so a checkpoint of a
+    GA population takes about P*n/8 bytes.
+*/
+class CheckpointWriter {
+    std::string _bytes;
+
+  public:
+    explicit CheckpointWriter(const std::string &solver);
+
+    template <typename T>
+    void put(const T &value) {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values are written as raw bytes");
+        _bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void put_vector(const std::vector<T> &values) {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values are written as raw bytes");
+        put(std::uint64_t(values.size()));
+        _bytes.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    void put_string(const std::string &value);
+    void put_bitfield(const std::vector<int> &bitfield);
+    void put_chromosome(const Chromosome &chromosome);
+    void put_random(const Random &random);
+    void put_mapping(const VertexMapping &mapping);
+    void put_trace(const std::vector<TracePoint> &trace);
+    std::string& bytes();
+};
+
+class CheckpointReader {
+    std::string _path;
+    std::string _bytes;
+    std::size_t _position = 0;
+
+    void require(std::size_t num_bytes);
+
+  public:
+    CheckpointReader(const std::string &path, const std::string &solver);
+
+    template <typename T>
+    T get() {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values are read as raw bytes");
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, _bytes.data() + _position, sizeof(T));
+        _position += sizeof(T);
+        return value;
+    }
+
+    template <typename T>
+    std::vector<T> get_vector() {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values are read as raw bytes");
+        auto size = get<std::uint64_t>();
+        require(size * sizeof(T));
+        std::vector<T> values(size);
+        if (size) std::memcpy(values.data(), _bytes.data() + _position, size * sizeof(T));
+        _position += size * sizeof(T);
+        return values;
+    }
+
+    std::string get_string();
+    std::vector<int> get_bitfield();
+    Chromosome get_chromosome();
+    Random get_random();
+    VertexMapping get_mapping();
+    std::vector<TracePoint> get_trace();
+    void check(bool condition, const std::string &message) const;
+};
+
+/*
+    Writes checkpoints on a background thread, so the search only pauses to serialize its state into memory.  Each
+    checkpoint goes to <path>.tmp and is renamed over <path> once complete, so a crash mid-write leaves the previous
+    checkpoint intact.  If the search submits a checkpoint while the previous one is still being written, the older of
+    the two that are waiting is dropped.
+*/
+class AsyncCheckpointWriter {
+    std::string                 _path;
+    std::string                 _pending;
+    bool                        _has_pending    = false;
+    bool                        _stopping       = false;
+    long                        _num_written    = 0;
+    std::mutex                  _mutex;
+    std::condition_variable     _condition;
+    std::thread                 _thread;
+
+    void write_loop();
+
+  public:
+    explicit AsyncCheckpointWriter(const std::string &path);
+    ~AsyncCheckpointWriter();
+    AsyncCheckpointWriter(const AsyncCheckpointWriter&) = delete;
+    AsyncCheckpointWriter& operator=(const AsyncCheckpointWriter&) = delete;
+
+    void submit(CheckpointWriter &&checkpoint);
+    void flush();
+    long num_written();
+    const std::string& path() const;
+};
+
+#endif
@@ -2,6 +2,8 @@
 Chromosome.cpp: This module contains the Chromosome class, which represents a bitfield representation of a vertex cover.  Furthermore, it contains variables that cache the result of a vertex cover query computation, such as number of edges not covered, number of bits that are flipped ON, etc.  Since the underlying representation is the bitfield, Chromosome is used by both GA and IMMC algorithms.
 */
 #include "Chromosome.h"
+#include "CompressedGraph.h"
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 
@@ -13,13 +15,43 @@ Chromosome Chromosome::full_cover(int size) {
     size = std::abs(size);
     chromosome.bitfield = vector<int>(size, 1);
     chromosome.filled_bits = size;
+    chromosome.cover_weight = size;
     chromosome.is_vc = true;
     chromosome.score = 1;
+    chromosome.rehash();
+    return chromosome;
+}
+
+template <typename Graph>
+Chromosome Chromosome::full_cover(const Graph &graph) {
+    // As above, with the cover's weight (and so its score) from the graph's vertex weights
+    auto chromosome = full_cover(graph.num_vertices());
+    chromosome.cover_weight = int(graph.total_vertex_weight());
+    chromosome.update_score(graph.max_vertex_weight());
     return chromosome;
 }
 
 Chromosome::Chromosome(const vector<int> &_bitfield) {
     bitfield = _bitfield;
+    rehash();
+}
+
+uint64_t Chromosome::bit_key(int bit_index) {
+    /*
+        Zobrist key of a bit: a fixed pseudo-random 64-bit value (splitmix64 of the index, so no table to size or
+        share), and the hash of a bitfield is the XOR of the keys of its ON bits.  Flipping a bit XORs its key in or
+        out, so the hash costs O(1) per flip, and equal bitfields always have equal hashes.
+    */
+    auto z = uint64_t(bit_index) + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void Chromosome::rehash() {
+    // O(n) recomputation, for when the bitfield was assigned directly instead of flipped
+    hash = 0;
+    for (auto i=0U; i < bitfield.size(); ++i) if (bitfield[i] != 0) hash ^= bit_key(i);
 }
 
 void Chromosome::calculate_score(const EdgeDenotedGraph &_graph) {
@@ -37,44 +69,166 @@ void Chromosome::calculate_score(const EdgeDenotedGraph &_graph) {
         The first term in the sum penalizes on larger sizes of potential vertex cover (1 if vertex is used; 0 if not)
         The second term penalizes non-covered edges of potential vertex cover (add n for every edge not covered).
 
-        The objective is to minimize f(x), or maximize 1/f(x)
+        The objective is to minimize f(x), or maximize 1/f(x).  On a weighted graph x_i counts w_i, and the penalty
+        is scaled by the largest weight so an uncovered edge still costs more than any cover.
     */
     filled_bits = num_vertices_used;
+    cover_weight = num_vertices_used;
+    if (_graph.is_weighted()) {
+        cover_weight = 0;
+        for (auto i=0U; i < bitfield.size(); ++i) if (bitfield[i] != 0) cover_weight += _graph.vertex_weight(i);
+    }
+    uncovered_edges = num_uncovered_edges;
     is_vc = _is_vc;
-    score = double(num_vertices_used) + double(num_uncovered_edges)*num_uncovered_edges*bitfield.size();
+    update_score(_graph.max_vertex_weight());
+}
+
+void Chromosome::update_score(int max_vertex_weight) {
+    // The fitness function above, from the cached counts (kept up to date by the incremental updates below)
+    score = double(cover_weight) + double(uncovered_edges)*uncovered_edges*bitfield.size()*max_vertex_weight;
     score = bitfield.size() / score;
 }
 
 void Chromosome::update_with_bit_flip(const EdgeDenotedGraph &_graph, int bit_index) {
     bitfield[bit_index]         = (bitfield[bit_index] == 0) ? 1 : 0;
+    hash                        ^= bit_key(bit_index);
     auto tup                    = _graph.vertex_cover_check_using_bitfield(bitfield);
     is_vc                       = std::get<0>(tup);
     filled_bits                 = std::get<1>(tup);
+    uncovered_edges             = std::get<2>(tup);
+    cover_weight                += (bitfield[bit_index] != 0) ? _graph.vertex_weight(bit_index) : -_graph.vertex_weight(bit_index);
+}
+
+void Chromosome::update_with_bit_flip(int bit_index, int marginal_edge_cost) {
+    // The O(1) update (see Chromosome.h) on an unweighted graph
+    update_with_bit_flip(bit_index, marginal_edge_cost, UnitWeights());
 }
 
 void Chromosome::perform_crossover(Chromosome &other, int position) {
     for (int i=position; i < bitfield.size(); ++i) {
+        if (bitfield[i] == other.bitfield[i]) continue;
         std::swap(bitfield[i], other.bitfield[i]);
+        hash ^= bit_key(i); other.hash ^= bit_key(i);
     }
 }
 
+template <typename Graph>
+int Chromosome::perform_crossover(const Graph &_graph, Chromosome &other, int position) {
+    /*
+        Same as the above, but keeps both children's cached counts up to date.  Only the tail bits where the parents
+        differ change, so each is flipped with the incremental update, in each child; flips compose, so the counts
+        come out exact at O(sum of the degrees of those bits) instead of a full O(|E|) cover check.  Returns the number
+        of bits that differed.
+    */
+    return with_weight_policy(_graph, [&](const auto &weights) {
+        auto num_flipped = 0;
+        for (int i=position; i < int(bitfield.size()); ++i) {
+            if (bitfield[i] == other.bitfield[i]) continue;
+            update_with_bit_flip(i, _graph.incremental_edge_cost_of_bit_flip(bitfield, i), weights);
+            other.update_with_bit_flip(i, _graph.incremental_edge_cost_of_bit_flip(other.bitfield, i), weights);
+            num_flipped++;
+        } return num_flipped;
+    });
+}
+
+template <typename Graph>
+void Chromosome::swap_bits(const Graph &_graph, Chromosome &other, const std::vector<int> &bit_indices) {
+    // Exchanges the given bits with the other chromosome, keeping both chromosomes' counts up to date as above
+    with_weight_policy(_graph, [&](const auto &weights) {
+        for (const auto i : bit_indices) {
+            if (bitfield[i] == other.bitfield[i]) continue;
+            update_with_bit_flip(i, _graph.incremental_edge_cost_of_bit_flip(bitfield, i), weights);
+            other.update_with_bit_flip(i, _graph.incremental_edge_cost_of_bit_flip(other.bitfield, i), weights);
+        }
+    });
+}
+
+template <typename Graph>
+int Chromosome::repair(const Graph &_graph, const std::vector<int> &bit_indices) {
+    /*
+        Greedily covers the uncovered edges at the given bits (e.g. the ones a crossover just changed), by turning on
+        the endpoint of higher degree, which is likelier to cover other edges too (of higher degree per unit weight,
+        on a weighted graph).  Costs O(sum of their degrees); uncovered edges elsewhere are left to later generations.
+        Returns the number of bits turned on.
+    */
+    return with_weight_policy(_graph, [&](const auto &weights) {
+        auto num_added = 0;
+        for (const auto i : bit_indices) {
+            if (bitfield[i] != 0) continue;
+            _graph.for_each_neighbor(i, [&](int neighbor_idx) {
+                if (bitfield[i] != 0 or bitfield[neighbor_idx] != 0) return;
+                auto bit_index = (long(_graph.degree(neighbor_idx)) * weights[i] > long(_graph.degree(i)) * weights[neighbor_idx]) ? neighbor_idx : i;
+                update_with_bit_flip(bit_index, _graph.incremental_edge_cost_of_bit_flip(bitfield, bit_index), weights);
+                num_added++;
+            });
+        } return num_added;
+    });
+}
+
+template <typename Graph>
+int Chromosome::local_search(const Graph &_graph, const std::vector<int> &bit_indices) {
+    /*
+        Tries to lighten the cover at each of the given bits, never uncovering an edge:
+          * a redundant vertex (all of its neighbours are in the cover) is removed;
+          * a vertex with exactly one neighbour w outside the cover is swapped for w, and any of w's other neighbours
+            the swap makes redundant are removed.  The swap is kept if the vertex and the removed neighbours outweigh
+            w, which on a weighted graph can hold with none removed; unweighted, at least one must be removed.
+        Each attempt costs O(degree) (the swap, O(degree of w's neighbourhood)).  Returns the number of improvements:
+        bits removed, plus swaps kept without removing any.
+    */
+    return with_weight_policy(_graph, [&](const auto &weights) {
+        auto num_improvements = 0;
+        vector<int> freed;
+        for (const auto i : bit_indices) {
+            if (bitfield[i] == 0) continue;
+            auto cost = _graph.incremental_edge_cost_of_bit_flip(bitfield, i);
+            if (cost == 0) { update_with_bit_flip(i, 0, weights); num_improvements++; continue; }
+            if (cost != 1) continue;
+
+            auto w = -1;
+            _graph.for_each_neighbor(i, [&](int neighbor_idx) { if (bitfield[neighbor_idx] == 0) w = neighbor_idx; });
+            update_with_bit_flip(i, cost, weights);
+            update_with_bit_flip(w, _graph.incremental_edge_cost_of_bit_flip(bitfield, w), weights);
+
+            long weight_freed = 0;
+            freed.clear();
+            _graph.for_each_neighbor(w, [&](int neighbor_idx) {
+                if (bitfield[neighbor_idx] != 0 and _graph.incremental_edge_cost_of_bit_flip(bitfield, neighbor_idx) == 0) {
+                    update_with_bit_flip(neighbor_idx, 0, weights);
+                    freed.emplace_back(neighbor_idx); weight_freed += weights[neighbor_idx];
+                }
+            });
+
+            // With unit weights this is num_freed > 0: a swap that removes nothing only trades one vertex for another
+            if (weights[i] + weight_freed > weights[w]) { num_improvements += std::max(int(freed.size()), 1); continue; }
+
+            // Lighter before the swap: put the freed vertices back, then undo the swap itself
+            for (const auto neighbor_idx : freed) update_with_bit_flip(neighbor_idx, _graph.incremental_edge_cost_of_bit_flip(bitfield, neighbor_idx), weights);
+            update_with_bit_flip(w, _graph.incremental_edge_cost_of_bit_flip(bitfield, w), weights);
+            update_with_bit_flip(i, _graph.incremental_edge_cost_of_bit_flip(bitfield, i), weights);
+        } return num_improvements;
+    });
+}
+
 void Chromosome::print() const {
     for (auto &bit : bitfield) cout << bit << " ";
     cout << endl;
 }
 
-void Chromosome::write_solution_to_file(const std::string &filepath) const {
+void Chromosome::write_solution_to_file(const std::string &filepath, const std::vector<long> &vertex_ids) const {
+    // Vertices are written 1-based, or by the ids the input file used if they are given (see RawMetisFile::OriginalIds)
     std::ofstream ofs(filepath.c_str(), std::ofstream::out);
     ofs.sync_with_stdio(false);
 
-    ofs << filled_bits << "\n";
+    ofs << cover_weight << "\n";
     for (auto i=0U; i < bitfield.size(); ++i) {
-        if (bitfield[i] != 0) ofs << (i+1) << ",";
+        if (bitfield[i] != 0) ofs << (vertex_ids.empty() ? long(i+1) : vertex_ids[i]) << ",";
     } ofs << "\n";
 }
 
 bool Chromosome::operator==(const Chromosome &other) const {
-    // Short-circuit the comparison operator by returning false if the scores or number of bits filled don't match.
+    // Short-circuit the comparison operator by returning false if the hashes, scores or number of bits filled don't match.
+    if (hash != other.hash) return false;
     if (score != other.score) return false;
     if (filled_bits != other.filled_bits) return false;
 
@@ -91,3 +245,14 @@ bool Chromosome::operator<(const Chromosome &other) const {
         }
     } return false;
 }
+
+template Chromosome Chromosome::full_cover(const EdgeDenotedGraph&);
+template Chromosome Chromosome::full_cover(const CompressedGraph&);
+template int Chromosome::perform_crossover(const EdgeDenotedGraph&, Chromosome&, int);
+template int Chromosome::perform_crossover(const CompressedGraph&, Chromosome&, int);
+template void Chromosome::swap_bits(const EdgeDenotedGraph&, Chromosome&, const std::vector<int>&);
+template void Chromosome::swap_bits(const CompressedGraph&, Chromosome&, const std::vector<int>&);
+template int Chromosome::repair(const EdgeDenotedGraph&, const std::vector<int>&);
+template int Chromosome::repair(const CompressedGraph&, const std::vector<int>&);
+template int Chromosome::local_search(const EdgeDenotedGraph&, const std::vector<int>&);
+template int Chromosome::local_search(const CompressedGraph&, const std::vector<int>&);
@@ -3,25 +3,58 @@
 
 #include "EdgeDenotedGraph.h"
 #include "Random.h"
+#include "WeightPolicy.h"
+#include <cstdint>
 #include <vector>
 
 struct Chromosome {
 	bool is_vc 		= false;
     double score 	= 0;
     int filled_bits = 0;
+    int cover_weight = 0;       // Sum of the weights of the bits that are ON (filled_bits on an unweighted graph)
+    long uncovered_edges = 0;
     std::vector<int> bitfield;
+    std::uint64_t hash = 0;     // XOR of bit_key(i) over the bits that are ON, kept up to date by every flip
 
     Chromosome() = default;
     Chromosome(const std::vector<int> &_bitfield);
     void calculate_score(const EdgeDenotedGraph &graph);
+    void update_score(int max_vertex_weight=1);
+    void rehash();
     void update_with_bit_flip(const EdgeDenotedGraph &_graph, int bit_index);
+    void update_with_bit_flip(int bit_index, int marginal_edge_cost);
+    template <typename Weights> void update_with_bit_flip(int bit_index, int marginal_edge_cost, const Weights &weights);
     void perform_crossover(Chromosome &other, int position);
+
+    // These take an EdgeDenotedGraph or a CompressedGraph (instantiated for both in Chromosome.cpp)
+    template <typename Graph> int perform_crossover(const Graph &graph, Chromosome &other, int position);
+    template <typename Graph> void swap_bits(const Graph &graph, Chromosome &other, const std::vector<int> &bit_indices);
+    template <typename Graph> int repair(const Graph &graph, const std::vector<int> &bit_indices);
+    template <typename Graph> int local_search(const Graph &graph, const std::vector<int> &bit_indices);
+
     void print() const;
-    void write_solution_to_file(const std::string &filepath) const;
+    void write_solution_to_file(const std::string &filepath, const std::vector<long> &vertex_ids = {}) const;
     bool operator==(const Chromosome &other) const;
     bool operator<(const Chromosome &other) const;
 
     static Chromosome full_cover(int size);
+    template <typename Graph> static Chromosome full_cover(const Graph &graph);
+    static std::uint64_t bit_key(int bit_index);
 };
 
+template <typename Weights>
+void Chromosome::update_with_bit_flip(int bit_index, int marginal_edge_cost, const Weights &weights) {
+    /*
+        O(1) version of the full update, given the marginal cost from EdgeDenotedGraph::incremental_edge_cost_of_bit_flip
+        computed *before* the flip.  The marginal cost is exactly the change in the number of uncovered edges.
+    */
+    auto added                  = (bitfield[bit_index] == 0);
+    filled_bits                 += added ? 1 : -1;
+    cover_weight                += added ? weights[bit_index] : -weights[bit_index];
+    bitfield[bit_index]         = added ? 1 : 0;
+    hash                        ^= bit_key(bit_index);
+    uncovered_edges             += marginal_edge_cost;
+    is_vc                       = (uncovered_edges == 0);
+}
+
 #endif
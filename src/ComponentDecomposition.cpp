@@ -0,0 +1,126 @@
+/*
+ComponentDecomposition.cpp: This module splits a graph into connected components, solves the small ones exactly with a bitmask branch-and-reduce (or, for dense ones of more than 64 vertices, through a maximum independent set), and leaves the large ones to the metaheuristics
+*/
+#include "ComponentDecomposition.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+    inline int popcount(uint64_t mask) { return __builtin_popcountll(mask); }
+    inline int lowest_bit(uint64_t mask) { return __builtin_ctzll(mask); }
+    inline uint64_t bit(int i) { return uint64_t(1) << i; }
+}
+
+BitmaskVertexCover::BitmaskVertexCover(const EdgeDenotedGraph &graph, const vector<int> &vertices) {
+    // Local ids are positions in vertices; vertices must be closed under neighbourhood (e.g. a whole component)
+    vector<int> local_ids(graph.num_vertices(), -1);
+    for (auto i=0U; i < vertices.size(); ++i) local_ids[ vertices[i] ] = i;
+
+    _adjacency.assign(vertices.size(), 0);
+    for (auto i=0U; i < vertices.size(); ++i) {
+        graph.for_each_neighbor(vertices[i], [&](int neighbor_idx) {
+            if (local_ids[neighbor_idx] >= 0 and local_ids[neighbor_idx] != int(i)) _adjacency[i] |= bit(local_ids[neighbor_idx]);
+        });
+    }
+}
+
+void BitmaskVertexCover::branch(uint64_t remaining, uint64_t cover, int size) {
+    _num_nodes++;
+
+    // Reduce until no vertex of degree 0 or 1 is left
+    for (auto changed = true; changed; ) {
+        changed = false;
+        for (auto rest = remaining; rest; rest &= rest - 1) {
+            auto v = lowest_bit(rest);
+            if (not (remaining & bit(v))) continue;
+            auto neighbors = _adjacency[v] & remaining;
+            if (neighbors == 0) { remaining &= ~bit(v); changed = true; }
+            else if (popcount(neighbors) == 1) {
+                cover |= neighbors; size++;
+                remaining &= ~(bit(v) | neighbors);
+                changed = true;
+            }
+        }
+    }
+    if (size >= _best_size) return;
+    if (remaining == 0) { _best_size = size; _best_cover = cover; return; }
+
+    // Every remaining vertex now has degree >= 2; bound by |E| / max degree and branch on a vertex of max degree
+    auto branch_vertex = -1, max_degree = 0, twice_num_edges = 0;
+    for (auto rest = remaining; rest; rest &= rest - 1) {
+        auto v = lowest_bit(rest);
+        auto degree = popcount(_adjacency[v] & remaining);
+        twice_num_edges += degree;
+        if (degree > max_degree) { max_degree = degree; branch_vertex = v; }
+    }
+    auto num_edges = twice_num_edges / 2;
+    if (size + (num_edges + max_degree - 1) / max_degree >= _best_size) return;
+
+    auto neighbors = _adjacency[branch_vertex] & remaining;
+    branch(remaining & ~bit(branch_vertex), cover | bit(branch_vertex), size + 1);
+    branch(remaining & ~(neighbors | bit(branch_vertex)), cover | neighbors, size + popcount(neighbors));
+}
+
+vector<int> BitmaskVertexCover::solve() {
+    // Returns the local ids (positions in the vertex list) of a minimum cover
+    auto n = int(_adjacency.size());
+    auto all = (n == 64) ? ~uint64_t(0) : bit(n) - 1;
+    _best_cover = all; _best_size = n + 1; _num_nodes = 0;
+    branch(all, 0, 0);
+
+    vector<int> cover;
+    for (auto rest = _best_cover; rest; rest &= rest - 1) cover.emplace_back( lowest_bit(rest) );
+    return cover;
+}
+
+long BitmaskVertexCover::num_nodes() const {
+    return _num_nodes;
+}
+
+ComponentDecomposition::ComponentDecomposition(const EdgeDenotedGraph &graph, int max_exact_size) {
+    max_exact_size = std::min(max_exact_size, int(BitsetGraph::MAX_VERTICES));
+    auto components = graph.connected_components();
+    num_components = components.size();
+
+    // Exact covers of the components that could be solved, by component
+    vector<vector<int>> covers(components.size());
+    vector<char> solved(components.size(), 0);
+    Stopwatch stopwatch;
+    for (auto i=0U; i < components.size(); ++i) {
+        const auto &component = components[i];
+        if (int(component.size()) > max_exact_size) continue;
+        if (int(component.size()) <= BitmaskVertexCover::MAX_VERTICES) {
+            covers[i] = BitmaskVertexCover(graph, component).solve();
+            solved[i] = 1;
+        } else {
+            auto time_left = EXACT_TIME_BUDGET_MS - stopwatch.elapsed_ms();
+            if (time_left <= 0) continue;
+            BitsetVertexCover search(graph, component);
+            covers[i] = search.solve(0, time_left);
+            solved[i] = search.complete();
+        }
+    }
+
+    // If everything was solved, hand the largest component to the solver anyway
+    if (std::find(solved.begin(), solved.end(), 0) == solved.end() and not components.empty()) {
+        auto largest = std::max_element(components.begin(), components.end(), [](const vector<int> &a, const vector<int> &b) { return a.size() < b.size(); });
+        solved[largest - components.begin()] = 0;
+    }
+
+    mapping.new_ids.assign(graph.num_vertices(), -1);
+    mapping.input_ids = graph.original_ids();
+    for (auto i=0U; i < components.size(); ++i) {
+        const auto &component = components[i];
+        if (not solved[i]) {
+            // Left to the solver, keeping the original relative order of its vertices
+            for (const auto vertex : component) mapping.original_ids.emplace_back(vertex);
+            continue;
+        }
+        for (const auto local_id : covers[i]) mapping.fixed_cover.emplace_back( component[local_id] );
+        num_solved++;
+    }
+
+    std::sort(mapping.original_ids.begin(), mapping.original_ids.end());
+    for (auto new_id=0U; new_id < mapping.original_ids.size(); ++new_id) mapping.new_ids[ mapping.original_ids[new_id] ] = new_id;
+}
@@ -0,0 +1,51 @@
+#ifndef CSE6140_COMPONENT_DECOMPOSITION_
+#define CSE6140_COMPONENT_DECOMPOSITION_
+
+#include "EdgeDenotedGraph.h"
+#include "BitsetGraph.h"
+#include "VertexOrdering.h"
+#include <cstdint>
+#include <vector>
+
+/*
+    Exact minimum vertex cover of a graph of at most 64 vertices, each held as a 64-bit neighbour mask.  Branch and
+    reduce: vertices of degree 0 are dropped and vertices of degree 1 force their neighbour into the cover; otherwise
+    the search branches on a vertex v of maximum degree (v in the cover, or all of N(v) in it), pruning with the bound
+    |E| / max degree.  Fine for sparse components; dense ones of 64 vertices can take a long time.
+*/
+class BitmaskVertexCover {
+    std::vector<std::uint64_t>  _adjacency;
+    std::uint64_t               _best_cover = 0;
+    int                         _best_size  = 0;
+    long                        _num_nodes  = 0;
+
+    void branch(std::uint64_t remaining, std::uint64_t cover, int size);
+
+  public:
+    static const int MAX_VERTICES = 64;
+
+    BitmaskVertexCover(const EdgeDenotedGraph &graph, const std::vector<int> &vertices);
+    std::vector<int> solve();
+    long num_nodes() const;
+};
+
+/*
+    Splits a graph into its connected components and solves every component of at most max_exact_size vertices
+    exactly: up to 64 vertices with BitmaskVertexCover, beyond that (up to BitsetGraph::MAX_VERTICES) through a
+    maximum independent set with BitsetVertexCover, which is fast on dense components but can take very long on sparse
+    ones, so those searches share EXACT_TIME_BUDGET_MS and any component not finished by then is unsolved.  mapping
+    drops the solved components (their covers go in mapping.fixed_cover) and relabels the rest, so a solver can run on
+    mapping.apply(graph) alone; if every component is solved, the largest one is left to the solver so it still has a
+    graph to run on.
+*/
+struct ComponentDecomposition {
+    int             num_components  = 0;
+    int             num_solved      = 0;
+    VertexMapping   mapping;
+
+    static constexpr double EXACT_TIME_BUDGET_MS = 1000;
+
+    ComponentDecomposition(const EdgeDenotedGraph &graph, int max_exact_size=BitmaskVertexCover::MAX_VERTICES);
+};
+
+#endif
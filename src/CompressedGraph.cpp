@@ -0,0 +1,195 @@
+/*
+CompressedGraph.cpp: gap-encoded varint adjacency lists with implicit edge ids, for graphs that do not fit in memory as an EdgeDenotedGraph
+*/
+#include "CompressedGraph.h"
+#include "ThreadPool.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+    const int NUM_CHUNKS = 256;
+
+    void write_varint(vector<unsigned char> &out, unsigned value) {
+        while (value >= 0x80) { out.emplace_back((unsigned char)(value | 0x80)); value >>= 7; }
+        out.emplace_back((unsigned char)(value));
+    }
+}
+
+CompressedGraph::CompressedGraph(const string &filepath, int num_threads) {
+    if (RawMetisFile::detect_format(filepath) != GraphFormat::METIS) {
+        // Edge lists and Matrix Market files only give a vertex's neighbours once every edge is read, so are read in full
+        *this = CompressedGraph(RawMetisFile::read(filepath, GraphFormat::AUTO, num_threads), num_threads);
+        return;
+    }
+
+    // Each chunk of the file is encoded into its own buffer as the parser hands over its rows
+    vector<vector<unsigned char>> chunk_bytes;
+    vector<int> first_vertex, weights;
+    RawMetisFile::read_metis_rows(filepath, num_threads,
+        [&](int num_vertices, bool is_weighted, const vector<int> &chunk_first_vertex) {
+            first_vertex = chunk_first_vertex;
+            chunk_bytes.resize(first_vertex.size() - 1);
+            offsets.assign(num_vertices + 1, 0);
+            first_edge.assign(num_vertices + 1, 0);
+            if (is_weighted) weights.assign(num_vertices, 1);
+        },
+        [&](int chunk, int vertex, vector<int> &neighbors, int weight) {
+            encode_row(chunk_bytes[chunk], vertex, neighbors);
+            if (not weights.empty()) weights[vertex] = weight;
+        });
+    join_chunks(chunk_bytes, first_vertex);
+    set_vertex_weights(std::move(weights));
+}
+
+CompressedGraph::CompressedGraph(RawMetisFile &&file, int num_threads) {
+    // Frees each row of the file as soon as it is encoded, so the peak is not both graphs in full
+    auto &rows = file.Connections;
+    auto n = int(rows.size());
+    vector<int> first_vertex(NUM_CHUNKS + 1);
+    for (int chunk=0; chunk <= NUM_CHUNKS; ++chunk) first_vertex[chunk] = int(long(n) * chunk / NUM_CHUNKS);
+    vector<vector<unsigned char>> chunk_bytes(NUM_CHUNKS);
+    offsets.assign(n + 1, 0);
+    first_edge.assign(n + 1, 0);
+
+    ThreadPool pool( (num_threads > 0) ? num_threads : ThreadPool::hardware_threads() );
+    pool.parallel_for(NUM_CHUNKS, [&](int chunk, int) {
+        for (int v=first_vertex[chunk]; v < first_vertex[chunk + 1]; ++v) { encode_row(chunk_bytes[chunk], v, rows[v]); vector<int>().swap(rows[v]); }
+    });
+    rows.clear();
+    join_chunks(chunk_bytes, first_vertex);
+    set_vertex_weights(std::move(file.VertexWeights));
+    _original_ids = std::move(file.OriginalIds);
+}
+
+void CompressedGraph::encode_row(vector<unsigned char> &out, int vertex, vector<int> &row) {
+    // Appends the vertex's list to its chunk's buffer; offsets[vertex + 1] is relative to the chunk until join_chunks
+    std::sort(row.begin(), row.end());
+    offsets[vertex + 1] = out.size();
+    write_varint(out, row.size());
+    int previous = 0;
+    for (const auto neighbor_idx : row) { write_varint(out, unsigned(neighbor_idx - previous)); previous = neighbor_idx; }
+    first_edge[vertex + 1] = row.end() - std::upper_bound(row.begin(), row.end(), vertex);
+}
+
+void CompressedGraph::join_chunks(vector<vector<unsigned char>> &chunk_bytes, const vector<int> &first_vertex) {
+    // offsets[v + 1] holds the start of v's list within its chunk; turn that into a global offset, and the counts of
+    // edges to higher vertices into a prefix sum
+    auto n = num_vertices();
+    long long total = 0;
+    for (auto chunk=0U; chunk < chunk_bytes.size(); ++chunk) {
+        for (int v=first_vertex[chunk]; v < first_vertex[chunk + 1]; ++v) offsets[v] = total + offsets[v + 1];
+        total += chunk_bytes[chunk].size();
+    } offsets[n] = total;
+    for (int v=0; v < n; ++v) first_edge[v + 1] += first_edge[v];
+
+    bytes.reserve(total);
+    for (auto &chunk : chunk_bytes) { bytes.insert(bytes.end(), chunk.begin(), chunk.end()); vector<unsigned char>().swap(chunk); }
+}
+
+void CompressedGraph::set_vertex_weights(vector<int> &&weights) {
+    // Every vertex weighs 1 unless the file gave vertex weights, as on EdgeDenotedGraph
+    _vertex_weights = std::move(weights);
+    _total_vertex_weight = num_vertices();
+    if (_vertex_weights.empty()) return;
+    _total_vertex_weight = 0; _max_vertex_weight = 0;
+    for (const auto weight : _vertex_weights) { _total_vertex_weight += weight; _max_vertex_weight = std::max(_max_vertex_weight, weight); }
+    _max_vertex_weight = std::max(_max_vertex_weight, 1);
+}
+
+int CompressedGraph::num_vertices() const {
+    return offsets.empty() ? 0 : int(offsets.size()) - 1;
+}
+
+long long CompressedGraph::num_edges() const {
+    return first_edge.empty() ? 0 : first_edge.back();
+}
+
+int CompressedGraph::degree(int vertex) const {
+    unsigned degree;
+    read_varint(bytes.data() + offsets[vertex], degree);
+    return int(degree);
+}
+
+CompressedGraph::NeighborRange CompressedGraph::neighbors(int vertex) const {
+    unsigned degree;
+    auto p = read_varint(bytes.data() + offsets[vertex], degree);
+    return NeighborRange { NeighborIterator(p, degree), NeighborIterator(p, 0) };
+}
+
+long long CompressedGraph::edge_index(int u, int v) const {
+    if (u > v) std::swap(u, v);
+    auto rank = first_edge[u];
+    for (const auto neighbor_idx : neighbors(u)) {
+        if (neighbor_idx <= u) continue;
+        if (neighbor_idx == v) return rank;
+        if (neighbor_idx > v) break;
+        rank++;
+    } return -1;
+}
+
+pair<int,int> CompressedGraph::edge_nodes(long long edge_idx) const {
+    // The vertex owning the id is the last one whose first edge is at or before it
+    auto u = int(std::upper_bound(first_edge.begin(), first_edge.end(), edge_idx) - first_edge.begin()) - 1;
+    auto rank = edge_idx - first_edge[u];
+    for (const auto neighbor_idx : neighbors(u)) {
+        if (neighbor_idx > u and rank-- == 0) return make_pair(u, neighbor_idx);
+    } return make_pair(-1, -1);
+}
+
+bool CompressedGraph::has_edge(int u, int v) const {
+    for (const auto neighbor_idx : neighbors(u)) {
+        if (neighbor_idx >= v) return neighbor_idx == v;
+    } return false;
+}
+
+int CompressedGraph::incremental_edge_cost_of_bit_flip(const vector<int> &bitfield, int bit_index) const {
+    // Same as EdgeDenotedGraph: the edges that only bit_index covers (or would cover), negative when setting the bit
+    auto edges_affected = 0;
+    for_each_neighbor(bit_index, [&](int neighbor_idx) { if (bitfield[neighbor_idx] == 0) edges_affected++; });
+    return (bitfield[bit_index] == 0) ? -edges_affected : edges_affected;
+}
+
+tuple<bool, int, long long> CompressedGraph::vertex_cover_check_using_bitfield(const vector<int> &bitfield) const {
+    auto num_vertices_set = 0; long long num_uncovered_edges = 0;
+    for (int u=0; u < num_vertices(); ++u) {
+        if (bitfield[u] != 0) { num_vertices_set++; continue; }
+        for_each_neighbor(u, [&](int neighbor_idx) { if (neighbor_idx > u and bitfield[neighbor_idx] == 0) num_uncovered_edges++; });
+    } return make_tuple(num_uncovered_edges == 0, num_vertices_set, num_uncovered_edges);
+}
+
+int CompressedGraph::vertex_weight(int vertex) const {
+    return is_weighted() ? _vertex_weights[vertex] : 1;
+}
+
+const vector<int>& CompressedGraph::vertex_weights() const {
+    return _vertex_weights;
+}
+
+int CompressedGraph::max_vertex_weight() const {
+    return _max_vertex_weight;
+}
+
+long CompressedGraph::total_vertex_weight() const {
+    return _total_vertex_weight;
+}
+
+const vector<long>& CompressedGraph::original_ids() const {
+    return _original_ids;
+}
+
+size_t CompressedGraph::memory_bytes() const {
+    return bytes.capacity() * sizeof(unsigned char) + (offsets.capacity() + first_edge.capacity()) * sizeof(long long)
+         + _vertex_weights.capacity() * sizeof(int) + _original_ids.capacity() * sizeof(long);
+}
+
+RawMetisFile CompressedGraph::to_metis_file() const {
+    RawMetisFile file;
+    file.VertexWeights = _vertex_weights;
+    file.OriginalIds = _original_ids;
+    file.Connections.resize(num_vertices());
+    for (int v=0; v < num_vertices(); ++v) {
+        file.Connections[v].reserve(degree(v));
+        for_each_neighbor(v, [&](int neighbor_idx) { file.Connections[v].emplace_back(neighbor_idx); });
+    } return file;
+}
@@ -0,0 +1,130 @@
+#ifndef CSE6140_COMPRESSED_GRAPH_
+#define CSE6140_COMPRESSED_GRAPH_
+
+#include "RawMetisFile.h"
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/*
+    Read-only adjacency for graphs too large for EdgeDenotedGraph.  Each vertex's sorted neighbor list is stored as
+    varints: the degree, the first neighbor, then the gaps between consecutive neighbors, which for most graphs fit
+    in one or two bytes per entry instead of EdgeDenotedGraph's ~8 plus edge ids and maps.
+
+    Edge ids are not stored: edge (u, v) with u < v has id first_edge[u] + (rank of v among u's neighbors above u),
+    the same numbering EdgeDenotedGraph gives a graph with sorted rows.  degree(), for_each_neighbor(), the bitfield
+    checks and the vertex weights have the same shape as on EdgeDenotedGraph, so code templated on the graph type (the
+    GA and IMMC search loops, under --compressed) can run on either.
+
+    A METIS file is encoded as it is parsed, one chunk of lines per thread, so its rows are never held in full; other
+    formats are read into a RawMetisFile first, whose rows are freed as they are encoded.
+*/
+class CompressedGraph {
+    std::vector<unsigned char>  bytes;
+    std::vector<long long>      offsets;        // start of each vertex's list in bytes; num_vertices + 1 entries
+    std::vector<long long>      first_edge;     // id of each vertex's first edge to a higher vertex; num_vertices + 1 entries
+    std::vector<int>            _vertex_weights;        // empty for unweighted graphs
+    std::vector<long>           _original_ids;
+    int                         _max_vertex_weight      = 1;
+    long                        _total_vertex_weight    = 0;
+
+    void encode_row(std::vector<unsigned char> &out, int vertex, std::vector<int> &row);
+    void join_chunks(std::vector<std::vector<unsigned char>> &chunk_bytes, const std::vector<int> &first_vertex);
+    void set_vertex_weights(std::vector<int> &&weights);
+
+  public:
+    static const unsigned char* read_varint(const unsigned char *p, unsigned &value) {
+        value = 0;
+        for (int shift=0; ; shift += 7) {
+            auto byte = *p++;
+            value |= unsigned(byte & 0x7f) << shift;
+            if (not (byte & 0x80)) return p;
+        }
+    }
+
+    // Decodes one neighbor list on the fly
+    class NeighborIterator {
+        const unsigned char *_p;
+        int _remaining, _neighbor;
+
+      public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef int value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const int* pointer;
+        typedef const int& reference;
+
+        NeighborIterator(const unsigned char *p, int remaining) : _p(p), _remaining(remaining), _neighbor(0) { if (_remaining > 0) advance(0); }
+        void advance(int base) { unsigned gap; _p = read_varint(_p, gap); _neighbor = base + int(gap); }
+        int operator*() const { return _neighbor; }
+        NeighborIterator& operator++() { if (--_remaining > 0) advance(_neighbor); return *this; }
+        bool operator!=(const NeighborIterator &other) const { return _remaining != other._remaining; }
+        bool operator==(const NeighborIterator &other) const { return _remaining == other._remaining; }
+    };
+
+    struct NeighborRange {
+        NeighborIterator _begin, _end;
+        NeighborIterator begin() const { return _begin; }
+        NeighborIterator end() const { return _end; }
+    };
+
+    CompressedGraph() = default;
+    explicit CompressedGraph(const std::string &filepath, int num_threads=0);
+    explicit CompressedGraph(RawMetisFile &&file, int num_threads=0);
+
+    int num_vertices() const;
+    long long num_edges() const;
+    int degree(int vertex) const;
+    NeighborRange neighbors(int vertex) const;
+    template <typename F> void for_each_neighbor(int vertex, F &&f) const;
+    template <typename F> void for_each_incident_edge(int vertex, F &&f) const;
+
+    long long edge_index(int u, int v) const;
+    std::pair<int,int> edge_nodes(long long edge_idx) const;
+    bool has_edge(int u, int v) const;
+
+    int incremental_edge_cost_of_bit_flip(const std::vector<int> &bitfield, int bit_index) const;
+    std::tuple<bool, int, long long> vertex_cover_check_using_bitfield(const std::vector<int> &bitfield) const;
+
+    bool is_weighted() const;
+    int vertex_weight(int vertex) const;
+    const std::vector<int>& vertex_weights() const;
+    int max_vertex_weight() const;
+    long total_vertex_weight() const;
+    const std::vector<long>& original_ids() const;
+
+    size_t memory_bytes() const;
+    RawMetisFile to_metis_file() const;
+};
+
+typedef std::shared_ptr<const CompressedGraph> CompressedGraphHandle;
+
+// Inline, like EdgeDenotedGraph's, since the solvers check it to pick their weight policy on every cycle
+inline bool CompressedGraph::is_weighted() const {
+    return not _vertex_weights.empty();
+}
+
+// Calls f(neighbor_idx) for every neighbor of the vertex, in increasing order
+template <typename F>
+void CompressedGraph::for_each_neighbor(int vertex, F &&f) const {
+    unsigned degree, gap;
+    auto p = read_varint(bytes.data() + offsets[vertex], degree);
+    int neighbor = 0;
+    for (unsigned i=0; i < degree; ++i) { p = read_varint(p, gap); neighbor += int(gap); f(neighbor); }
+}
+
+// Calls f(neighbor_idx, edge_idx) for every edge of the vertex; ids of edges to lower vertices take a scan of the
+// lower vertex's list
+template <typename F>
+void CompressedGraph::for_each_incident_edge(int vertex, F &&f) const {
+    auto next_edge = first_edge[vertex];
+    for_each_neighbor(vertex, [&](int neighbor_idx) {
+        f(neighbor_idx, (neighbor_idx > vertex) ? next_edge++ : edge_index(neighbor_idx, vertex));
+    });
+}
+
+#endif
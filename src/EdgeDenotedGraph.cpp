@@ -9,13 +9,33 @@ EdgeDenotedGraph.cpp: This module intakes RawMetisFile objects to construct Edge
 
 using namespace std;
 
-EdgeDenotedGraph::EdgeDenotedGraph(const std::string &filepath) {
-    metis_file = RawMetisFile(filepath);
+EdgeDenotedGraph::EdgeDenotedGraph(const std::string &filepath, bool build_edge_ids) : EdgeDenotedGraph(RawMetisFile::read(filepath), build_edge_ids) {}
+
+EdgeDenotedGraph::EdgeDenotedGraph(const RawMetisFile &file, bool build_edge_ids) : EdgeDenotedGraph(RawMetisFile(file), build_edge_ids) {}
+
+EdgeDenotedGraph::EdgeDenotedGraph(RawMetisFile &&file, bool build_edge_ids) {
+    metis_file = std::move(file);
     _num_edges = metis_file.num_edges();
     _num_vertices = metis_file.num_vertices();
 
-    max_vertex_degree = std::numeric_limits<double>::infinity();
+    // get the max vertex degree
+    max_vertex_degree = 0;
+    for (const auto &row : metis_file.Connections) {
+        if (row.size() > max_vertex_degree) max_vertex_degree = row.size();
+    }
+
+    // Every vertex weighs 1 unless the file gave vertex weights
+    _total_vertex_weight = _num_vertices;
+    if (metis_file.is_weighted()) {
+        _total_vertex_weight = 0; _max_vertex_weight = 0;
+        for (const auto weight : metis_file.VertexWeights) { _total_vertex_weight += weight; _max_vertex_weight = std::max(_max_vertex_weight, weight); }
+        _max_vertex_weight = std::max(_max_vertex_weight, 1);
+    }
+
+    if (build_edge_ids) this->build_edge_ids();
+}
 
+void EdgeDenotedGraph::build_edge_ids() {
     int edge_idx = 0;
     for (auto vertex_idx=0U; vertex_idx < metis_file.Connections.size(); ++vertex_idx) {
         vector<int> edges_connected_to_vertex_i;
@@ -31,21 +51,22 @@ EdgeDenotedGraph::EdgeDenotedGraph(const std::string &filepath) {
             }
         } IncidenceMatrix.emplace_back( std::move(edges_connected_to_vertex_i) );
     }
+    _has_edge_ids = true;
+}
 
-    // get the max vertex degree
-    for (int vertex_idx = 0; vertex_idx < _num_vertices; vertex_idx++) {
-        int edge_count = connected_edges(vertex_idx).size();
-        if(edge_count > max_vertex_degree) {
-            max_vertex_degree = edge_count;
-        }
+void EdgeDenotedGraph::require_edge_ids(const char *caller) const {
+    if (not _has_edge_ids) {
+        cout << "[EdgeDenotedGraph] " << caller << "() needs edge ids, but the graph was loaded adjacency-only!" << endl;
+        std::exit(-1);
     }
+}
 
-    //for (int i = 0; i < 10; i++) {
-    //    cout << edge_map.at(i).first << ", " << edge_map.at(i).second << endl;
-    //}
+bool EdgeDenotedGraph::has_edge_ids() const {
+    return _has_edge_ids;
 }
 
 void EdgeDenotedGraph::print() const {
+    require_edge_ids("print");
     for (auto vertex_idx=0U; vertex_idx < IncidenceMatrix.size(); ++vertex_idx) {
         cout << "[Vertex " << vertex_idx << "]: ";
         for (const auto &edge_idx : IncidenceMatrix[vertex_idx]) {
@@ -55,78 +76,48 @@ void EdgeDenotedGraph::print() const {
 }
 
 int EdgeDenotedGraph::get_source(int edge_idx) {
+    require_edge_ids("get_source");
     return edge_map.at(edge_idx).first;
 }
 
 int EdgeDenotedGraph::get_dest(int edge_idx) {
+    require_edge_ids("get_dest");
     return edge_map.at(edge_idx).second;
 }
 
 std::pair<int,int> EdgeDenotedGraph::get_edge_nodes(int edge_idx) {
+    require_edge_ids("get_edge_nodes");
     return edge_map.at(edge_idx);
 }
 
-vector<int> EdgeDenotedGraph::compute_edge_cover_using_vertex_idxs(const std::vector<int> &vertex_indices) const {
-    vector<int> bitfield(num_edges(), 0);
-    for (const auto i : vertex_indices) {
-        if (i >= IncidenceMatrix.size() or i < 0) continue;
-        for (const auto &edge_idx : IncidenceMatrix[i]) {
-            bitfield[edge_idx] = 1;
-        }
-    }
-    return bitfield;
-}
-
 bool EdgeDenotedGraph::is_vertex_cover(const std::vector<int> &vertex_indices) const {
-    auto bitfield = compute_edge_cover_using_vertex_idxs(vertex_indices);
-    for (const auto &b : bitfield) {
-        if (b == 0) return false;
-    } return true;
-}
-
-tuple<bool, int> EdgeDenotedGraph::vertex_cover_check(const std::vector<int> &vertex_indices) const {
-    auto bitfield = compute_edge_cover_using_vertex_idxs(vertex_indices);
-
-    auto is_vc = true; auto num_uncovered_edges = 0;
-    for (const auto &b : bitfield) {
-        if (b == 0) {
-            is_vc = false;
-            num_uncovered_edges++;
-        }
-    } return make_tuple(is_vc, num_uncovered_edges);
+    return std::get<0>(vertex_cover_check(vertex_indices));
 }
 
-tuple<int, vector<int>> EdgeDenotedGraph::compute_edge_cover_using_bitfield(const std::vector<int> &bitfield) const {
-    auto num_vertices = 0;
-    vector<int> edges_bitfield(num_edges(), 0);
-
-    for (auto idx=0U; idx < bitfield.size(); ++idx) {
-        if (bitfield[idx] == 0) continue;
-        num_vertices++;
-        for (const auto &edge_idx : IncidenceMatrix[idx]) {
-            edges_bitfield[edge_idx] = 1;
-        }
+tuple<bool, long> EdgeDenotedGraph::vertex_cover_check(const std::vector<int> &vertex_indices) const {
+    vector<int> bitfield(num_vertices(), 0);
+    for (const auto i : vertex_indices) {
+        if (i >= num_vertices() or i < 0) continue;
+        bitfield[i] = 1;
     }
-
-    return make_tuple(num_vertices, edges_bitfield);
+    auto tup = vertex_cover_check_using_bitfield(bitfield);
+    return make_tuple(std::get<0>(tup), std::get<2>(tup));
 }
 
 bool EdgeDenotedGraph::is_vertex_cover_using_bitfield(const std::vector<int> &bitfield) const {
-    auto vertex_count_edges_bitfield_pair = compute_edge_cover_using_bitfield(bitfield);
-    for (const auto &b : std::get<1>(vertex_count_edges_bitfield_pair)) {
-        if (b == 0) return false;
-    } return true;
-}
-
-std::tuple<bool, int, int> EdgeDenotedGraph::vertex_cover_check_using_bitfield(const std::vector<int> &bitfield) const {
-    auto vertex_count_edges_bitfield_pair = compute_edge_cover_using_bitfield(bitfield);
-    auto is_vc = true; auto num_uncovered_edges = 0;
-    for (const auto &b : std::get<1>(vertex_count_edges_bitfield_pair)) {
-        if (b == 0) {
-            is_vc = false;
-            num_uncovered_edges++;
+    return std::get<0>(vertex_cover_check_using_bitfield(bitfield));
+}
+
+std::tuple<bool, int, long> EdgeDenotedGraph::vertex_cover_check_using_bitfield(const std::vector<int> &bitfield) const {
+    // Walks the adjacency lists rather than marking covered edge ids, so it needs no edge ids and no scratch space:
+    // each edge (u, v) with u < v is seen once from u, and is uncovered if neither end is set
+    auto num_vertices_set = 0; long num_uncovered_edges = 0;
+    for (auto idx=0U; idx < bitfield.size(); ++idx) {
+        if (bitfield[idx] != 0) { num_vertices_set++; continue; }
+        for (const auto neighbor_idx : metis_file.Connections[idx]) {
+            if (int(idx) < neighbor_idx and bitfield[neighbor_idx] == 0) num_uncovered_edges++;
         }
-    } return make_tuple(is_vc, std::get<0>(vertex_count_edges_bitfield_pair), num_uncovered_edges);
+    } return make_tuple(num_uncovered_edges == 0, num_vertices_set, num_uncovered_edges);
 }
 
 int EdgeDenotedGraph::incremental_edge_cost_of_bit_flip(const std::vector<int> &bitfield, int bit_index) const {
@@ -141,38 +132,84 @@ int EdgeDenotedGraph::incremental_edge_cost_of_bit_flip(const std::vector<int> &
     return (bitfield[bit_index] == 0) ? -edges_affected : edges_affected;
 }
 
+int EdgeDenotedGraph::degree(int vertex) const {
+    return metis_file.Connections[vertex].size();
+}
+
 int EdgeDenotedGraph::num_vertices() const {
     return _num_vertices;
 }
 
-int EdgeDenotedGraph::num_edges() const {
+long EdgeDenotedGraph::num_edges() const {
     return _num_edges;
 }
 
-RawMetisFile EdgeDenotedGraph::to_metis_file() const {
-    auto mfile = metis_file;
-    return mfile;
+const RawMetisFile& EdgeDenotedGraph::to_metis_file() const {
+    return metis_file;
+}
+
+int EdgeDenotedGraph::vertex_weight(int vertex) const {
+    return metis_file.is_weighted() ? metis_file.VertexWeights[vertex] : 1;
+}
+
+const std::vector<int>& EdgeDenotedGraph::vertex_weights() const {
+    // One weight per vertex, contiguous; empty for an unweighted graph
+    return metis_file.VertexWeights;
+}
+
+int EdgeDenotedGraph::max_vertex_weight() const {
+    return _max_vertex_weight;
+}
+
+long EdgeDenotedGraph::total_vertex_weight() const {
+    return _total_vertex_weight;
+}
+
+const std::vector<long>& EdgeDenotedGraph::original_ids() const {
+    // Ids used by the input file (e.g. a SNAP edge list), or empty if vertex i was simply i+1
+    return metis_file.OriginalIds;
+}
+
+std::vector<std::vector<int>> EdgeDenotedGraph::connected_components() const {
+    // The vertices of each component in BFS order from its lowest vertex; components are ordered by that vertex
+    vector<vector<int>> components;
+    vector<char> visited(num_vertices(), 0);
+    for (int start=0; start < num_vertices(); ++start) {
+        if (visited[start]) continue;
+        visited[start] = 1;
+        components.emplace_back(1, start);
+        auto &component = components.back();
+        for (auto head=0U; head < component.size(); ++head) {
+            for (const auto neighbor_idx : metis_file.Connections[ component[head] ]) {
+                if (not visited[neighbor_idx]) { visited[neighbor_idx] = 1; component.emplace_back(neighbor_idx); }
+            }
+        }
+    } return components;
 }
 
 bool EdgeDenotedGraph::has_edge(int node1, int node2) const {
-    const std::vector<int>& row = IncidenceMatrix.at(node1);
-    for (const auto &edge : row) {
-    if ((edge_map.at(edge).first == node1 && edge_map.at(edge).second == node2) ||
-        (edge_map.at(edge).first == node2 && edge_map.at(edge).second == node1)) {
-        return true;
-    }
-    }
-    return false;
+    const auto &row = metis_file.Connections.at(node1);
+    return std::find(row.begin(), row.end(), node2) != row.end();
 }
 
-EdgeDenotedGraph EdgeDenotedGraph::copy() {
+EdgeDenotedGraph EdgeDenotedGraph::clone() const {
     EdgeDenotedGraph new_graph;
-
+    new_graph.IncidenceMatrix   = IncidenceMatrix;
+    new_graph.metis_file        = metis_file;
+    new_graph.connections_cache = connections_cache;
+    new_graph.edge_map          = edge_map;
+    new_graph._num_edges        = _num_edges;
+    new_graph._num_vertices     = _num_vertices;
+    new_graph._has_edge_ids     = _has_edge_ids;
+    new_graph.max_vertex_degree = max_vertex_degree;
+    new_graph._max_vertex_weight    = _max_vertex_weight;
+    new_graph._total_vertex_weight  = _total_vertex_weight;
     return new_graph;
 }
 
 int EdgeDenotedGraph::select_an_edge() {
-    int edge_cnt = std::rand() % num_edges();
+    require_edge_ids("select_an_edge");
+    long edge_cnt = std::rand() % num_edges();
 
     auto it = edge_map.begin();
     std::advance(it, edge_cnt);
@@ -194,10 +231,12 @@ int EdgeDenotedGraph::select_a_node()
 }
 
 const std::vector<int>& EdgeDenotedGraph::connected_edges(int node) {
+    require_edge_ids("connected_edges");
     return IncidenceMatrix.at(node);
 }
 
 void EdgeDenotedGraph::remove_edge(int edge_idx) {
+    require_edge_ids("remove_edge");
     int source = edge_map.at(edge_idx).first;
     vector<int> source_row = IncidenceMatrix.at(source);
     for (auto i = 0U; i < source_row.size(); i++) {
@@ -224,6 +263,7 @@ void EdgeDenotedGraph::remove_edge(int edge_idx) {
 
 void EdgeDenotedGraph::add_edge(int edge_idx, std::pair<int,int> edge_nodes)
 {
+    require_edge_ids("add_edge");
     // add back to edge_map
     edge_map.insert(std::pair<int, std::pair<int,int>>(edge_idx, std::pair<int,int>(edge_nodes.first, edge_nodes.second)));
 
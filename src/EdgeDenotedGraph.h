@@ -9,6 +9,7 @@
 #include <tuple>
 #include <cstdlib>
 #include <limits>
+#include <memory>
 
 class EdgeDenotedGraph {
 private:
@@ -17,33 +18,57 @@ private:
     std::map<std::pair<int, int>, int> connections_cache;
     std::map<int, std::pair<int, int>> edge_map;
 
-    int _num_edges      = 0;
+    long _num_edges     = 0;
     int _num_vertices   = 0;
+    bool _has_edge_ids  = false;
+    int _max_vertex_weight      = 1;
+    long _total_vertex_weight   = 0;
 
-    std::vector<int> compute_edge_cover_using_vertex_idxs(const std::vector<int> &vertex_indices) const;
-    std::tuple<int, std::vector<int>> compute_edge_cover_using_bitfield(const std::vector<int> &bitfield) const;
+    void build_edge_ids();
+    void require_edge_ids(const char *caller) const;
 
     void print_incidence_matrix();
 public:
+    /*
+        With build_edge_ids=false the graph is adjacency-only: it keeps just the neighbor lists, which is all the GA
+        and IMMC need, and skips the incidence matrix and edge maps.  The edge-id methods (get_edge_nodes,
+        connected_edges, remove_edge, ...) then exit with an error; the vertex cover queries work either way.
+    */
     EdgeDenotedGraph() = default;
-    EdgeDenotedGraph(const std::string &filepath);
+    EdgeDenotedGraph(const EdgeDenotedGraph&) = delete;
+    EdgeDenotedGraph& operator=(const EdgeDenotedGraph&) = delete;
+    EdgeDenotedGraph(EdgeDenotedGraph&&) = default;
+    EdgeDenotedGraph& operator=(EdgeDenotedGraph&&) = default;
+    EdgeDenotedGraph(const std::string &filepath, bool build_edge_ids=true);
+    EdgeDenotedGraph(const RawMetisFile &file, bool build_edge_ids=true);
+    EdgeDenotedGraph(RawMetisFile &&file, bool build_edge_ids=true);
+    bool has_edge_ids() const;
     int get_source(int edge_idx);
     int get_dest(int edge_idx);
     std::pair<int, int> get_edge_nodes(int edge_idx);
     void print() const;
     bool is_vertex_cover(const std::vector<int> &vertex_indices) const;
-    std::tuple<bool, int> vertex_cover_check(const std::vector<int> &vertex_indices) const;
+    std::tuple<bool, long> vertex_cover_check(const std::vector<int> &vertex_indices) const;
     bool is_vertex_cover_using_bitfield(const std::vector<int> &bitfield) const;
-    std::tuple<bool, int, int> vertex_cover_check_using_bitfield(const std::vector<int> &bitfield) const;
+    std::tuple<bool, int, long> vertex_cover_check_using_bitfield(const std::vector<int> &bitfield) const;
     int incremental_edge_cost_of_bit_flip(const std::vector<int> &bitfield, int bit_index) const;
+    int degree(int vertex) const;
+    template <typename F> void for_each_neighbor(int vertex, F &&f) const;
     int num_vertices() const;
-    int num_edges() const;
-    RawMetisFile to_metis_file() const;
+    long num_edges() const;
+    const RawMetisFile& to_metis_file() const;
+    bool is_weighted() const;
+    int vertex_weight(int vertex) const;
+    const std::vector<int>& vertex_weights() const;
+    int max_vertex_weight() const;
+    long total_vertex_weight() const;
+    const std::vector<long>& original_ids() const;
+    std::vector<std::vector<int>> connected_components() const;
 
     double max_vertex_degree;
     
     bool has_edge(int node1, int node2) const;
-    EdgeDenotedGraph copy();
+    EdgeDenotedGraph clone() const;
     int select_an_edge();
     int select_a_node();
     const std::vector<int>& connected_edges(int node);
@@ -51,4 +76,21 @@ public:
     void add_edge(int edge_idx, std::pair<int,int> edge_nodes);
 };
 
+/*
+    Graphs can be large, so EdgeDenotedGraph is move-only: copies are made explicitly with clone(), and solvers share
+    one loaded graph through a GraphHandle.
+*/
+typedef std::shared_ptr<const EdgeDenotedGraph> GraphHandle;
+
+// Inline, since the solvers check it to pick their weight policy on every cycle
+inline bool EdgeDenotedGraph::is_weighted() const {
+    return not metis_file.VertexWeights.empty();
+}
+
+// Calls f(neighbor_idx) for every neighbor of the vertex
+template <typename F>
+void EdgeDenotedGraph::for_each_neighbor(int vertex, F &&f) const {
+    for (const auto neighbor_idx : metis_file.Connections[vertex]) f(neighbor_idx);
+}
+
 #endif
@@ -3,19 +3,180 @@ GeneticAlgoSearch.cpp: This module contains the routines for GA.  The routines s
 */
 #include "GeneticAlgoSearch.h"
 #include "Utilities.h"
+#include "GraphReduction.h"
 #include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <limits>
 
 using namespace std;
 
+CrossoverType parse_crossover(const string &name) {
+    if (name == "single-point")     return CrossoverType::SINGLE_POINT;
+    if (name == "uniform")          return CrossoverType::UNIFORM;
+    if (name == "subgraph")         return CrossoverType::SUBGRAPH;
+    if (name == "repairing")        return CrossoverType::REPAIRING;
+
+    cout << "[ GENETIC ALGORITHM ]: Unknown crossover '" << name << "'; expected one of [ single-point, uniform, subgraph, repairing ]\n";
+    std::exit(-1);
+}
+
+string crossover_name(CrossoverType crossover) {
+    switch (crossover) {
+        case CrossoverType::SINGLE_POINT:   return "single-point";
+        case CrossoverType::UNIFORM:        return "uniform";
+        case CrossoverType::SUBGRAPH:       return "subgraph";
+        case CrossoverType::REPAIRING:      return "repairing";
+    } return "unknown";
+}
+
 GeneticAlgoSearch::GeneticAlgoSearch(const string &filepath) {
     _filepath = filepath;
-    _graph = EdgeDenotedGraph(filepath);
+    _graph = std::make_shared<EdgeDenotedGraph>(filepath, false);
+    _pool = std::make_shared<SolutionPool>();
+}
+
+GeneticAlgoSearch::GeneticAlgoSearch(const string &filepath, GraphHandle graph) {
+    // Reuse a graph that has already been loaded; filepath is only used to name the output files
+    _filepath = filepath;
+    _graph = std::move(graph);
+    _pool = std::make_shared<SolutionPool>();
+}
+
+GeneticAlgoSearch::GeneticAlgoSearch(const string &filepath, CompressedGraphHandle graph) {
+    // Searches a CompressedGraph (--compressed), for graphs too large for EdgeDenotedGraph; it cannot be relabelled
+    // or reduced, so set_vertex_ordering, apply_reductions and graph() are unavailable
+    _filepath = filepath;
+    _compressed = std::move(graph);
+    _pool = std::make_shared<SolutionPool>();
+}
+
+template <typename F>
+auto GeneticAlgoSearch::with_graph(F &&f) const -> decltype(f(std::declval<const EdgeDenotedGraph&>())) {
+    if (_compressed) return f(*_compressed);
+    return f(*_graph);
+}
+
+void GeneticAlgoSearch::require_full_graph(const string &feature) const {
+    if (not _compressed) return;
+    cout << "[ GENETIC ALGORITHM ]: " << feature << " is not supported with --compressed" << endl;
+    std::exit(-1);
+}
+
+int GeneticAlgoSearch::num_vertices() const {
+    return with_graph([](const auto &graph) { return graph.num_vertices(); });
+}
+
+void GeneticAlgoSearch::set_solution_pool(shared_ptr<SolutionPool> pool) {
+    // Covers found are kept in this pool, which may be shared with other solvers on the same (relabelled, reduced) graph
+    _pool = std::move(pool);
+}
+
+void GeneticAlgoSearch::set_output_directory(const string &directory) {
+    _output_directory = directory;
+}
+
+void GeneticAlgoSearch::set_log_stream(std::ostream &log) {
+    // Progress messages go here instead of cout, e.g. to a stream of the caller's own when solvers run side by side
+    _log = &log;
+}
+
+void GeneticAlgoSearch::set_vertex_ordering(OrderingType ordering) {
+    // Relabel the graph so a crossover point splits it into two mostly separate regions, rather than cutting across
+    // edges all over the graph; solutions are mapped back on output
+    require_full_graph("Vertex ordering");
+    auto ordering_mapping = VertexMapping(*_graph, ordering);
+    if (not ordering_mapping.is_identity()) _graph = std::make_shared<EdgeDenotedGraph>( ordering_mapping.apply(_graph->to_metis_file()), false );
+    _mapping = _mapping.then(ordering_mapping);
+    *_log << "[ GENETIC ALGORITHM ]: Using vertex ordering '" << VertexMapping::type_name(ordering) << "'" << endl;
+}
+
+void GeneticAlgoSearch::apply_reductions(bool lp_reduction, int max_exact_component) {
+    // See reduce_graph(); call before init
+    if (not lp_reduction and max_exact_component == 0) return;
+    require_full_graph("Graph reduction");
+    auto reduced = reduce_graph(_graph, _mapping, lp_reduction, max_exact_component, *_log, "[ GENETIC ALGORITHM ]: ");
+    _graph = std::move(reduced.graph);
+    _mapping = std::move(reduced.mapping);
+}
+
+void GeneticAlgoSearch::set_crossover(CrossoverType crossover) {
+    _crossover = crossover;
+    *_log << "[ GENETIC ALGORITHM ]: Using crossover '" << crossover_name(crossover) << "'" << endl;
+}
+
+void GeneticAlgoSearch::set_local_search(int probes_per_chromosome) {
+    // Memetic mode: after mutation, every chromosome gets a local search at this many random vertices (0: off)
+    _local_search_probes = std::max(0, probes_per_chromosome);
+    *_log << "[ GENETIC ALGORITHM ]: Local search at " << _local_search_probes << " vertices per chromosome and generation" << endl;
+}
+
+void GeneticAlgoSearch::set_checkpoint(const string &path, double interval_sec) {
+    // Every interval_sec seconds of the run, snapshot the search and write it to path on a background thread
+    _checkpoint_writer.reset(new AsyncCheckpointWriter(path));
+    _checkpoint_interval_ms = std::max(0.0, interval_sec) * 1000.0;
+    *_log << "[ GENETIC ALGORITHM ]: Checkpointing to '" << path << "' every " << interval_sec << "s" << endl;
+}
+
+void GeneticAlgoSearch::set_improvement_callback(ImprovementCallback callback) {
+    // Called with every new best cover, as it is written to the trace file
+    _on_improvement = std::move(callback);
+}
+
+void GeneticAlgoSearch::set_cancellation(CancellationHandle token) {
+    // Checked every cycle alongside the time budget; a cancelled run stops and writes its best cover as at the cutoff
+    _cancellation = std::move(token);
+}
+
+void GeneticAlgoSearch::write_checkpoint(int iteration) {
+    CheckpointWriter checkpoint("GA");
+    checkpoint.put(_crossover_probability); checkpoint.put(_mutation_probability); checkpoint.put(_elite_size);
+    checkpoint.put(_population_size); checkpoint.put(_crossover); checkpoint.put(_local_search_probes);
+    checkpoint.put(iteration); checkpoint.put(stopwatch.elapsed_ms()); checkpoint.put(_best_cost);
+    checkpoint.put_random(ran3);
+    checkpoint.put_mapping(_mapping);
+    checkpoint.put_trace(_trace);
+    checkpoint.put_chromosome(_best);
+    checkpoint.put(uint64_t(Population.size()));
+    for (const auto &chromosome : Population) checkpoint.put_chromosome(chromosome);
+    _pool->save(checkpoint);
+    _checkpoint_writer->submit(std::move(checkpoint));
+}
+
+void GeneticAlgoSearch::resume(const string &checkpoint_path) {
+    // Restores a search saved by set_checkpoint, in place of the reductions and init; run_for_ms then carries on from
+    // the checkpoint's iteration and elapsed time, towards the same time budget
+    CheckpointReader checkpoint(checkpoint_path, "GA");
+    _crossover_probability  = checkpoint.get<double>();
+    _mutation_probability   = checkpoint.get<double>();
+    _elite_size             = checkpoint.get<int>();
+    _population_size        = checkpoint.get<int>();
+    _crossover              = checkpoint.get<CrossoverType>();
+    _local_search_probes    = checkpoint.get<int>();
+    _start_iteration        = checkpoint.get<int>();
+    _start_ms               = checkpoint.get<double>();
+    _best_cost              = checkpoint.get<int>();
+    ran3                    = checkpoint.get_random();
+
+    auto mapping = checkpoint.get_mapping();
+    checkpoint.check(mapping.original_ids.empty() or int(mapping.new_ids.size()) == num_vertices(), "was written for a different graph");
+    if (not mapping.original_ids.empty()) require_full_graph("Resuming a relabelled or reduced search");
+    if (not mapping.original_ids.empty()) _graph = std::make_shared<EdgeDenotedGraph>( mapping.apply(_graph->to_metis_file()), false );
+    _mapping = std::move(mapping);
+    _trace = checkpoint.get_trace();
+    _best = checkpoint.get_chromosome();
+
+    Population.resize( checkpoint.get<uint64_t>() );
+    for (auto &chromosome : Population) chromosome = checkpoint.get_chromosome();
+    checkpoint.check(Population.empty() or int(Population[0].bitfield.size()) == num_vertices(), "was written for a different graph");
+    _pool->load(checkpoint);
+
+    *_log << "[ GENETIC ALGORITHM ]: Resuming '" << checkpoint_path << "' at cycle " << _start_iteration << " ("
+         << (_start_ms / 1000.0) << "s), best cover so far " << (_best_cost + _mapping.fixed_cover.size()) << endl;
 }
 
 void GeneticAlgoSearch::init(int population_size, int rand_seed) {
-    init(population_size, 0.9, 1.5/_graph.num_vertices(), int(0.1 * 100), rand_seed);
+    init(population_size, 0.9, 1.5/num_vertices(), int(0.1 * 100), rand_seed);
 }
 
 void GeneticAlgoSearch::init(int population_size, double crossover_probability, double mutation_probability, int elite_size, int rand_seed) {
@@ -26,10 +187,13 @@ void GeneticAlgoSearch::init(int population_size, double crossover_probability,
     ran3                    = Random(rand_seed);
 
     // Initialize population with full vertex-covers
-    best_solution_found_so_far = Chromosome::full_cover(_graph.num_vertices());
-    Population.clear(); Population.resize(population_size, best_solution_found_so_far);
+    with_graph([&](const auto &graph) {
+        _best = Chromosome::full_cover(graph);
+        _best_cost = _best.cover_weight;
+        Population.clear(); Population.resize(population_size, _best);
+    });
 
-    cout << "[ GENETIC ALGORITHM ]: Initializing with the following parameters:\n"
+    *_log << "[ GENETIC ALGORITHM ]: Initializing with the following parameters:\n"
          << "filepath               = " << _filepath << "\n"
          << "rand_seed              = " << rand_seed << "\n"
          << "population_size        = " << population_size << "\n"
@@ -38,15 +202,33 @@ void GeneticAlgoSearch::init(int population_size, double crossover_probability,
          << "elite_size             = " << elite_size << "\n" << endl;
 }
 
-void GeneticAlgoSearch::compute_fitness_scores_and_prune(int iteration) {
-    // Compute and update chromosomes with scores
-    for (auto &chromosome : Population) chromosome.calculate_score(_graph);
+template <typename Graph>
+void GeneticAlgoSearch::compute_fitness_scores_and_prune(const Graph &graph, int iteration) {
+    SolverStats::ScopedPhase timer(_stats, Phase::FITNESS);
+
+    // Update chromosomes with scores; crossover and mutation keep each chromosome's cover counts current, so this no
+    // longer needs a cover check per chromosome
+    auto max_vertex_weight = graph.max_vertex_weight();
+    for (auto &chromosome : Population) chromosome.update_score(max_vertex_weight);
+    _stats.count(Counter::FITNESS_EVALUATIONS, Population.size());
 
     if (iteration % 10000 == 0) {
-        // Sort by chromosome bitfield equality, prune away duplicated, and replace *half* the pruned-away chromosomes with full-cover chromosomes
-        std::sort(Population.begin(), Population.end());
-        Population.erase( std::unique(Population.begin(), Population.end()), Population.end() );
-        Population.resize(Population.size() + (_population_size - Population.size())/2, Chromosome::full_cover(_graph.num_vertices()));
+        // Prune away duplicated chromosomes by their hashes (equal hashes are confirmed bit by bit), and replace *half*
+        // the pruned-away chromosomes with full-cover chromosomes
+        _seen_hashes.clear();
+        auto num_kept = 0U;
+        for (auto i=0U; i < Population.size(); ++i) {
+            auto seen = _seen_hashes.find(Population[i].hash);
+            if (seen != _seen_hashes.end() and Population[seen->second] == Population[i]) continue;
+            if (seen == _seen_hashes.end()) _seen_hashes.emplace(Population[i].hash, num_kept);
+            if (num_kept != i) Population[num_kept] = std::move(Population[i]);
+            num_kept++;
+        }
+        _stats.count(Counter::DUPLICATES_REJECTED, Population.size() - num_kept);
+        Population.resize(num_kept);
+        auto num_added = (_population_size - Population.size())/2;
+        Population.resize(Population.size() + num_added, Chromosome::full_cover(graph));
+        _stats.count(Counter::ALLOCATIONS, num_added + 1);
     }
 
     // Sort by chromosome *score*, in descending order
@@ -61,7 +243,59 @@ Chromosome* GeneticAlgoSearch::pick_parent(double total_fitness) {
     } return chromosome;
 }
 
-void GeneticAlgoSearch::generate_children(std::vector<Chromosome> &second_generation, double total_fitness) {
+template <typename Graph>
+void GeneticAlgoSearch::grow_region(const Graph &graph, int start_vertex, int region_size) {
+    // Breadth-first from start_vertex until region_size vertices are collected (or its component runs out), into
+    // _swapped_bits; stamps mark the vertices already taken, so nothing is cleared between calls
+    if (int(_region_stamps.size()) != graph.num_vertices()) { _region_stamps.assign(graph.num_vertices(), 0); _region_stamp = 0; }
+    auto stamp = ++_region_stamp;
+
+    _swapped_bits.clear();
+    _swapped_bits.emplace_back(start_vertex); _region_stamps[start_vertex] = stamp;
+    for (auto head=0U; head < _swapped_bits.size() and int(_swapped_bits.size()) < region_size; ++head) {
+        graph.for_each_neighbor(_swapped_bits[head], [&](int neighbor_idx) {
+            if (_region_stamps[neighbor_idx] == stamp or int(_swapped_bits.size()) >= region_size) return;
+            _region_stamps[neighbor_idx] = stamp;
+            _swapped_bits.emplace_back(neighbor_idx);
+        });
+    }
+}
+
+template <typename Graph>
+void GeneticAlgoSearch::crossover(const Graph &graph, Chromosome &child1, Chromosome &child2) {
+    // Every operator swaps bits with Chromosome's incremental updates, so both children's cover counts stay exact
+    auto num_vertices = int(child1.bitfield.size());
+    switch (_crossover) {
+        case CrossoverType::SINGLE_POINT:
+            child1.perform_crossover( graph, child2, int(ran3(0, num_vertices)) );
+            break;
+
+        case CrossoverType::UNIFORM:
+            _swapped_bits.clear();
+            for (int i=0; i < num_vertices; ++i) if (ran3() < 0.5) _swapped_bits.emplace_back(i);
+            child1.swap_bits(graph, child2, _swapped_bits);
+            break;
+
+        case CrossoverType::SUBGRAPH:
+            // A region of up to half the graph, so each child still takes most of its bits from one parent
+            grow_region( graph, int(ran3(0, num_vertices)), 1 + int(ran3(0, num_vertices / 2)) );
+            child1.swap_bits(graph, child2, _swapped_bits);
+            break;
+
+        case CrossoverType::REPAIRING: {
+            auto position = int(ran3(0, num_vertices));
+            _swapped_bits.clear();
+            for (int i=position; i < num_vertices; ++i) if (child1.bitfield[i] != child2.bitfield[i]) _swapped_bits.emplace_back(i);
+            child1.swap_bits(graph, child2, _swapped_bits);
+            child1.repair(graph, _swapped_bits);
+            child2.repair(graph, _swapped_bits);
+            break;
+        }
+    }
+}
+
+template <typename Graph>
+void GeneticAlgoSearch::generate_children(const Graph &graph, std::vector<Chromosome> &second_generation, double total_fitness) {
     // Generate either 2 children with crossovers (with crossover probability) or cloning one parent
     if (ran3() < _crossover_probability) {
         // Choose 2 unique non-elite parents
@@ -72,43 +306,75 @@ void GeneticAlgoSearch::generate_children(std::vector<Chromosome> &second_genera
         second_generation.emplace_back( *parent1 );
         second_generation.emplace_back( *parent2 );
 
-        // Perform crossover
-        second_generation.back().perform_crossover( second_generation[second_generation.size()-2], int(ran3(0, parent1->bitfield.size())) );
+        // Perform crossover, updating both children's cover counts for the bits that actually change
+        crossover( graph, second_generation.back(), second_generation[second_generation.size()-2] );
+        _stats.count(Counter::CROSSOVERS);
+        _stats.count(Counter::ALLOCATIONS, 2);
     } else {
         // Pick random parent and clone
         second_generation.emplace_back( *pick_parent(total_fitness) );
+        _stats.count(Counter::ALLOCATIONS);
     }
 }
 
-void GeneticAlgoSearch::apply_mutations() {
+template <typename Graph>
+void GeneticAlgoSearch::apply_mutations(const Graph &graph) {
+    SolverStats::ScopedPhase timer(_stats, Phase::MUTATION);
+
     // Apply mutation to each bit in each chromosome with tiny mutation probability
-    for (auto &chromosome : Population) {
-        for (auto &bit : chromosome.bitfield) {
-            if (ran3() < _mutation_probability) {
-                bit = (bit == 0) ? 1 : 0;
+    with_weight_policy(graph, [&](const auto &weights) {
+        for (auto &chromosome : Population) {
+            for (int bit_index=0; bit_index < int(chromosome.bitfield.size()); ++bit_index) {
+                if (ran3() < _mutation_probability) {
+                    chromosome.update_with_bit_flip(bit_index, graph.incremental_edge_cost_of_bit_flip(chromosome.bitfield, bit_index), weights);
+                    _stats.count(Counter::MUTATIONS);
+                }
             }
         }
+    });
+}
+
+template <typename Graph>
+void GeneticAlgoSearch::apply_local_search(const Graph &graph) {
+    if (_local_search_probes == 0) return;
+    SolverStats::ScopedPhase timer(_stats, Phase::LOCAL_SEARCH);
+
+    // Redundant-vertex removals and 1-swaps at random vertices, which only ever shrink a chromosome's cover.  Covers
+    // the pool already holds were searched when they were first found (by this or another solver), so are skipped
+    for (auto &chromosome : Population) {
+        if (chromosome.is_vc and _pool->contains(chromosome.hash)) continue;
+        _probe_bits.clear();
+        for (int i=0; i < _local_search_probes; ++i) _probe_bits.emplace_back( int(ran3(0, chromosome.bitfield.size())) );
+        _stats.count(Counter::LOCAL_SEARCH_IMPROVEMENTS, chromosome.local_search(graph, _probe_bits));
     }
 }
 
 void GeneticAlgoSearch::find_best_valid_solution() {
-    Chromosome *best = nullptr;
-    for (auto &chromosome : Population) {
-        if (chromosome.is_vc and
-            ((best != nullptr and chromosome.filled_bits < best->filled_bits) or chromosome.filled_bits < best_solution_found_so_far.filled_bits)) {
-            best = &chromosome;
-        }
+    // Offer the pool every cover good enough to get in (it turns away copies of covers it already holds), and keep
+    // and log a new best in the trace file.  The best is kept apart from the pool, which may be shared with other solvers
+    const Chromosome *best = nullptr;
+    auto num_duplicates = _pool->num_duplicates();
+    for (const auto &chromosome : Population) {
+        if (not chromosome.is_vc) continue;
+        if (chromosome.cover_weight < (best ? best->cover_weight : _best_cost)) best = &chromosome;
+        if (_pool->accepts(chromosome.cover_weight)) _pool->insert(chromosome);
     }
+    _stats.count(Counter::DUPLICATES_REJECTED, _pool->num_duplicates() - num_duplicates);
 
     if (best) {
-        best_solution_found_so_far = *best;
-        tracefile << (stopwatch.elapsed_ms() / 1000.0) << "," << best_solution_found_so_far.filled_bits << endl;
+        _stats.count(Counter::SOLUTIONS_FOUND);
+        _best = *best;
+        _best_cost = _best.cover_weight;
+        _trace.push_back({ stopwatch.elapsed_ms() / 1000.0, _best_cost + int(_mapping.fixed_cover.size()) });
+        tracefile << _trace.back().time_sec << "," << _trace.back().cover_size << endl;
+        if (_on_improvement) _on_improvement({ "GA", _trace.back().time_sec, _trace.back().cover_size });
     }
 }
 
-void GeneticAlgoSearch::cycle(int iteration) {
+template <typename Graph>
+void GeneticAlgoSearch::cycle(const Graph &graph, int iteration) {
     // Compute/update fitness scores and sort the chromosomes in descending order of scores
-    compute_fitness_scores_and_prune(iteration);
+    compute_fitness_scores_and_prune(graph, iteration);
 
     // Find and record the best found solution
     find_best_valid_solution();
@@ -117,54 +383,104 @@ void GeneticAlgoSearch::cycle(int iteration) {
     double total_fitness = 0;
     for (auto i=0U; i < Population.size(); ++i) total_fitness += Population[i].score;
 
-    // Elitist selection (save the top N solutions for next round)
-    auto new_generation = decltype(Population)( Population.begin(), Population.begin() + _elite_size );
+    {
+        SolverStats::ScopedPhase timer(_stats, Phase::REPRODUCTION);
 
-    // Generate children
-    while (new_generation.size() < _population_size) {
-        generate_children(new_generation, total_fitness);
-    } new_generation.resize(Population.size());
+        // Elitist selection (save the top N solutions for next round)
+        auto new_generation = decltype(Population)( Population.begin(), Population.begin() + _elite_size );
+        _stats.count(Counter::ALLOCATIONS, _elite_size + 1);
 
-    // Set as the new population
-    Population = new_generation;
+        // Generate children
+        while (new_generation.size() < _population_size) {
+            generate_children(graph, new_generation, total_fitness);
+        } new_generation.resize(Population.size());
+
+        // Set as the new population
+        Population = new_generation;
+        _stats.count(Counter::ALLOCATIONS, Population.size());
+    }
 
-    // Apply mutations on the new generation
-    apply_mutations();
+    // Apply mutations on the new generation, then (in memetic mode) improve it with local search
+    apply_mutations(graph);
+    apply_local_search(graph);
 }
 
 int GeneticAlgoSearch::run_for_ms(double milliseconds, bool verbose) {
     milliseconds = std::abs(milliseconds);
-    cout << "[ GENETIC ALGORITHM ]: Running algorithm for target " << (milliseconds/1000.0) << "s..." << endl;
+    *_log << "[ GENETIC ALGORITHM ]: Running algorithm for target " << (milliseconds/1000.0) << "s..." << endl;
 
-    // Open tracefile
-    tracefile = std::ofstream( generate_trace_filepath(_filepath, "GA", milliseconds/1000.0, ran3.seed()).c_str(), std::ofstream::out );
+    // Open tracefile (a resumed run rewrites the points from before its checkpoint)
+    tracefile = std::ofstream( join_path(_output_directory, generate_trace_filepath(_filepath, "GA", milliseconds/1000.0, ran3.seed())).c_str(), std::ofstream::out );
+    if (_start_iteration == 0) _trace.clear();
     tracefile.sync_with_stdio(false);
+    for (const auto &point : _trace) tracefile << point.time_sec << "," << point.cover_size << endl;
 
     //　Run GA
-    stopwatch.reset(); auto iteration=0;
-    while (++iteration, stopwatch.elapsed_ms() < milliseconds) {
-        if (verbose) cout << "[ GENETIC ALGORITHM ] CYCLING (" << iteration << ")" << endl;
-        cycle(iteration);
-    }
+    stopwatch.reset(_start_ms); auto iteration=_start_iteration;
+    auto next_checkpoint_ms = _start_ms + _checkpoint_interval_ms;
+    with_graph([&](const auto &graph) {
+        SolverStats::ScopedPhase timer(_stats, Phase::SEARCH);
+        while (++iteration, stopwatch.elapsed_ms() < milliseconds and not is_cancelled(_cancellation)) {
+            if (verbose) *_log << "[ GENETIC ALGORITHM ] CYCLING (" << iteration << ")" << endl;
+            cycle(graph, iteration);
+            if (_checkpoint_writer and stopwatch.elapsed_ms() >= next_checkpoint_ms) {
+                write_checkpoint(iteration);
+                next_checkpoint_ms = stopwatch.elapsed_ms() + _checkpoint_interval_ms;
+            }
+        }
+    });
+    if (_checkpoint_writer) _checkpoint_writer->flush();
 
     // Final scores update
-    compute_fitness_scores_and_prune(iteration);
+    with_graph([&](const auto &graph) { compute_fitness_scores_and_prune(graph, iteration); });
     find_best_valid_solution();
-    cout << "[ GENETIC ALGORITHM ]: Finished running " << iteration << " cycles in approximately " << (stopwatch.elapsed_ms()/1000.0) << "s" << endl;
+    if (is_cancelled(_cancellation)) *_log << "[ GENETIC ALGORITHM ]: Cancelled" << endl;
+    *_log << "[ GENETIC ALGORITHM ]: Finished running " << iteration << " cycles in approximately " << (stopwatch.elapsed_ms()/1000.0) << "s" << endl;
 
-    auto solution_filepath = generate_solution_filepath(_filepath, "GA", milliseconds/1000.0, ran3.seed());
-    cout << "[ GENETIC ALGORITHM ]: Writing best solution found to file '" << solution_filepath << "'" << endl;
-    best_solution_found_so_far.write_solution_to_file(solution_filepath);
+    auto solution_filepath = join_path(_output_directory, generate_solution_filepath(_filepath, "GA", milliseconds/1000.0, ran3.seed()));
+    *_log << "[ GENETIC ALGORITHM ]: Writing best solution found to file '" << solution_filepath << "'" << endl;
+    // Written using the original vertex ids (and the input file's own ids, if it had any)
+    const auto &graph_ids = with_graph([](const auto &graph) -> const std::vector<long>& { return graph.original_ids(); });
+    best_solution().write_solution_to_file(solution_filepath, _mapping.original_ids.empty() ? graph_ids : _mapping.input_ids);
 
     return iteration;
 }
 
-std::vector<Chromosome> GeneticAlgoSearch::population() {
+void GeneticAlgoSearch::step(int num_cycles) {
+    // Runs cycles without a time budget or output files (used for benchmarking)
+    with_graph([&](const auto &graph) { for (int iteration=1; iteration <= num_cycles; ++iteration) cycle(graph, iteration); });
+}
+
+const std::vector<Chromosome>& GeneticAlgoSearch::population() const {
     return Population;
 }
 
-EdgeDenotedGraph GeneticAlgoSearch::graph() {
-    return _graph;
+const EdgeDenotedGraph& GeneticAlgoSearch::graph() const {
+    require_full_graph("graph()");
+    return *_graph;
+}
+
+const SolverStats& GeneticAlgoSearch::statistics() const {
+    return _stats;
+}
+
+Chromosome GeneticAlgoSearch::best_solution() const {
+    // In the input graph's vertex ids, whatever relabelling or reduction the search ran on
+    auto solution = _best;
+    if (_mapping.original_ids.empty()) return solution;
+    solution.bitfield = _mapping.to_original(solution.bitfield);
+    solution.filled_bits += _mapping.fixed_cover.size();
+    solution.cover_weight += _mapping.fixed_cover.size();
+    solution.rehash();
+    return solution;
+}
+
+const SolutionPool& GeneticAlgoSearch::solution_pool() const {
+    return *_pool;
+}
+
+const std::vector<TracePoint>& GeneticAlgoSearch::trace() const {
+    return _trace;
 }
 
 void GeneticAlgoSearch::print_population() const {
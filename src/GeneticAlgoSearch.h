@@ -2,43 +2,114 @@
 #define GENETIC_ALGO_SEARCH_H_
 
 #include "EdgeDenotedGraph.h"
+#include "CompressedGraph.h"
 #include "Chromosome.h"
 #include "Random.h"
 #include "Stopwatch.h"
+#include "SolverStats.h"
+#include "Utilities.h"
+#include "VertexOrdering.h"
+#include "SolutionPool.h"
+#include "Checkpoint.h"
+#include "SolverEvents.h"
 #include <vector>
 #include <fstream>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+
+/*
+    SINGLE_POINT swaps the tails of the parents' bitfields; UNIFORM swaps each bit with probability 1/2; SUBGRAPH swaps
+    a connected region grown by BFS from a random vertex, so the child keeps each parent's cover of whole
+    neighbourhoods; REPAIRING is SINGLE_POINT followed by a greedy repair of the edges the swap left uncovered.
+*/
+enum class CrossoverType { SINGLE_POINT, UNIFORM, SUBGRAPH, REPAIRING };
+CrossoverType parse_crossover(const std::string &name);
+std::string crossover_name(CrossoverType crossover);
 
 class GeneticAlgoSearch {
 private:
     Random                      ran3;
     Stopwatch                   stopwatch;
     std::ofstream               tracefile;
+    std::ostream                *_log       = &std::cout;
     std::string                 _filepath;
-    EdgeDenotedGraph            _graph;
+    std::string                 _output_directory;
+    GraphHandle                 _graph;
+    CompressedGraphHandle       _compressed;            // set instead of _graph by the CompressedGraph constructor
     std::vector<Chromosome>     Population;
-    Chromosome                  best_solution_found_so_far;
+    VertexMapping               _mapping;
+    std::vector<int>            _swapped_bits;
+    std::vector<int>            _region_stamps;
+    std::vector<int>            _probe_bits;
+    std::unordered_map<std::uint64_t, int> _seen_hashes;   // hash -> position of the first chromosome with it, when pruning
+    std::shared_ptr<SolutionPool> _pool;
+    int                         _best_cost;
+    Chromosome                  _best;                  // this search's own best cover, which best_solution() returns
+    std::vector<TracePoint>     _trace;
+    SolverStats                 _stats { "GA" };
 
     double  _crossover_probability  = 0;
     double  _mutation_probability   = 0;
     int     _elite_size             = 0;
     int     _population_size        = 0;
+    int     _region_stamp           = 0;
+    int     _local_search_probes    = 0;
+    CrossoverType _crossover        = CrossoverType::SINGLE_POINT;
+
+    // Observer of new best covers, and the token that stops the run early
+    ImprovementCallback         _on_improvement;
+    CancellationHandle          _cancellation;
+
+    // Periodic checkpoints, and where a resumed run picks up
+    std::unique_ptr<AsyncCheckpointWriter> _checkpoint_writer;
+    double  _checkpoint_interval_ms = 0;
+    int     _start_iteration        = 0;
+    double  _start_ms               = 0;
+
+    // The search loops are compiled for both graph types; with_graph calls f with the one the search runs on
+    template <typename F> auto with_graph(F &&f) const -> decltype(f(std::declval<const EdgeDenotedGraph&>()));
+    void require_full_graph(const std::string &feature) const;
+    int num_vertices() const;
 
-    void compute_fitness_scores_and_prune(int iteration);
+    template <typename Graph> void compute_fitness_scores_and_prune(const Graph &graph, int iteration);
     Chromosome* pick_parent(double total_fitness);
-    void generate_children(std::vector<Chromosome> &second_generation, double total_fitness);
-    void apply_mutations();
-    void cycle(int iteration);
+    template <typename Graph> void grow_region(const Graph &graph, int start_vertex, int region_size);
+    template <typename Graph> void crossover(const Graph &graph, Chromosome &child1, Chromosome &child2);
+    template <typename Graph> void generate_children(const Graph &graph, std::vector<Chromosome> &second_generation, double total_fitness);
+    template <typename Graph> void apply_mutations(const Graph &graph);
+    template <typename Graph> void apply_local_search(const Graph &graph);
+    template <typename Graph> void cycle(const Graph &graph, int iteration);
     void find_best_valid_solution();
+    void write_checkpoint(int iteration);
 
 public:
     GeneticAlgoSearch() = delete;
     GeneticAlgoSearch(const std::string &filepath);
+    GeneticAlgoSearch(const std::string &filepath, GraphHandle graph);
+    GeneticAlgoSearch(const std::string &filepath, CompressedGraphHandle graph);
     void init(int population_size, int rand_seed);
     void init(int population_size, double crossover_probability, double mutation_probability, int elite_size, int rand_seed);
+    void set_vertex_ordering(OrderingType ordering);
+    void apply_reductions(bool lp_reduction, int max_exact_component);
+    void set_crossover(CrossoverType crossover);
+    void set_local_search(int probes_per_chromosome);
+    void set_solution_pool(std::shared_ptr<SolutionPool> pool);
+    void set_output_directory(const std::string &directory);
+    void set_log_stream(std::ostream &log);
+    void set_checkpoint(const std::string &path, double interval_sec);
+    void set_improvement_callback(ImprovementCallback callback);
+    void set_cancellation(CancellationHandle token);
+    void resume(const std::string &checkpoint_path);
     int run_for_ms(double milliseconds, bool verbose=false);
-    EdgeDenotedGraph graph();
-    std::vector<Chromosome> population();
+    void step(int num_cycles);
+    const EdgeDenotedGraph& graph() const;
+    const std::vector<Chromosome>& population() const;
     void print_population() const;
+    const SolverStats& statistics() const;
+    Chromosome best_solution() const;
+    const SolutionPool& solution_pool() const;
+    const std::vector<TracePoint>& trace() const;
 };
 
 #endif
@@ -0,0 +1,42 @@
+/*
+GraphColoring.cpp: This module computes a greedy (largest-degree-first) coloring of an EdgeDenotedGraph, which splits the vertices into independent sets for parallel IMMC sweeps.
+*/
+#include "GraphColoring.h"
+#include <algorithm>
+
+using namespace std;
+
+GraphColoring::GraphColoring(const EdgeDenotedGraph &graph) {
+    auto num_vertices = graph.num_vertices();
+    vector<int> order(num_vertices);
+    for (int i=0; i < num_vertices; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return graph.degree(a) > graph.degree(b); });
+
+    // Give each vertex the smallest color not used by an already-colored neighbour
+    colors.assign(num_vertices, -1);
+    vector<int> color_used_by(int(graph.max_vertex_degree) + 2, -1);
+    for (const auto vertex : order) {
+        graph.for_each_neighbor(vertex, [&](int neighbor_idx) {
+            if (colors[neighbor_idx] >= 0) color_used_by[ colors[neighbor_idx] ] = vertex;
+        });
+        auto color = 0;
+        while (color_used_by[color] == vertex) color++;
+        colors[vertex] = color;
+    }
+
+    for (int vertex=0; vertex < num_vertices; ++vertex) {
+        if (colors[vertex] >= int(color_classes.size())) color_classes.resize(colors[vertex] + 1);
+        color_classes[ colors[vertex] ].emplace_back(vertex);
+    }
+}
+
+int GraphColoring::num_colors() const {
+    return color_classes.size();
+}
+
+bool GraphColoring::is_proper(const EdgeDenotedGraph &graph) const {
+    auto proper = true;
+    for (int vertex=0; vertex < graph.num_vertices(); ++vertex) {
+        graph.for_each_neighbor(vertex, [&](int neighbor_idx) { if (colors[neighbor_idx] == colors[vertex]) proper = false; });
+    } return proper;
+}
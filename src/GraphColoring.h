@@ -0,0 +1,21 @@
+#ifndef GRAPH_COLORING_H_
+#define GRAPH_COLORING_H_
+
+#include "EdgeDenotedGraph.h"
+#include <vector>
+
+/*
+    Greedy proper coloring of the graph (largest degree first).  No two vertices in the same color class share an
+    edge, so their Ising moves do not interact and can be made in parallel.
+*/
+struct GraphColoring {
+    std::vector<int>                colors;         // color of each vertex
+    std::vector<std::vector<int>>   color_classes;  // vertices of each color, in ascending order of id
+
+    GraphColoring() = default;
+    GraphColoring(const EdgeDenotedGraph &graph);
+    int num_colors() const;
+    bool is_proper(const EdgeDenotedGraph &graph) const;
+};
+
+#endif
@@ -0,0 +1,252 @@
+/*
+GraphGenerator.cpp: Erdos-Renyi, Barabasi-Albert, R-MAT, random geometric and planted-cover random graphs, generated in parallel and deterministically per seed
+*/
+#include "GraphGenerator.h"
+#include "Random.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <set>
+
+using namespace std;
+
+namespace {
+    const int MAX_TOP_UP_ROUNDS = 8;
+
+    // Seed of the random stream for one chunk of one round, so results do not depend on which thread runs the chunk
+    int chunk_seed(int rand_seed, int round, int chunk) {
+        unsigned long long x = (unsigned long long)(unsigned(rand_seed)) << 32 ^ (unsigned long long)(round) << 16 ^ chunk;
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return int((x ^ (x >> 31)) & 0x7fffffff);
+    }
+
+    // Splits [0, total) into NUM_CHUNKS contiguous ranges
+    long chunk_begin(long total, int chunk) {
+        return total * chunk / GraphGenerator::NUM_CHUNKS;
+    }
+}
+
+GraphModel GeneratorParameters::parse_model(const string &name) {
+    if (name == "erdos-renyi")      return GraphModel::ERDOS_RENYI;
+    if (name == "barabasi-albert")  return GraphModel::BARABASI_ALBERT;
+    if (name == "rmat")             return GraphModel::RMAT;
+    if (name == "geometric")        return GraphModel::GEOMETRIC;
+    if (name == "planted-cover")    return GraphModel::PLANTED_COVER;
+
+    cout << "[GraphGenerator] Unknown model '" << name << "'; expected one of [ erdos-renyi, barabasi-albert, rmat, geometric, planted-cover ]\n";
+    std::exit(-1);
+}
+
+string GeneratorParameters::model_name(GraphModel model) {
+    switch (model) {
+        case GraphModel::ERDOS_RENYI:       return "erdos-renyi";
+        case GraphModel::BARABASI_ALBERT:   return "barabasi-albert";
+        case GraphModel::RMAT:              return "rmat";
+        case GraphModel::GEOMETRIC:         return "geometric";
+        case GraphModel::PLANTED_COVER:     return "planted-cover";
+    } return "unknown";
+}
+
+GraphGenerator::GraphGenerator(const GeneratorParameters &params) : _params(params) {
+    auto n = _params.num_vertices;
+    auto max_edges = long(n) * (n - 1) / 2;
+    if (n < 2) {
+        cout << "[GraphGenerator] Need at least 2 vertices, but got " << n << "\n";
+        std::exit(-1);
+    }
+    _params.num_edges = std::min(_params.num_edges, max_edges);
+    _params.attachment = std::max(1, std::min(_params.attachment, n - 1));
+
+    if (_params.model == GraphModel::PLANTED_COVER) {
+        if (_params.cover_size <= 0) _params.cover_size = std::max(1, n / 4);
+        if (_params.cover_size > n / 2) {
+            cout << "[GraphGenerator] The planted cover is matched to as many other vertices, so it can have at most " << n / 2 << " vertices\n";
+            std::exit(-1);
+        }
+        // Every edge needs an endpoint in the cover
+        auto k = long(_params.cover_size);
+        _params.num_edges = std::max(k, std::min(_params.num_edges, k * (k - 1) / 2 + k * (n - k)));
+    }
+}
+
+const vector<int>& GraphGenerator::planted_cover() const {
+    return _planted_cover;
+}
+
+GraphGenerator::EdgeList GraphGenerator::sample_edges(ThreadPool &pool, long num_edges, int round) const {
+    // Independent uniform draws; duplicates are dropped when the adjacency lists are built
+    auto n = _params.num_vertices;
+    vector<EdgeList> chunks(NUM_CHUNKS);
+    int scale = 0;
+    while ((1L << scale) < n) scale++;
+
+    pool.parallel_for(NUM_CHUNKS, [&](int chunk, int) {
+        Random ran3(chunk_seed(_params.rand_seed, round, chunk));
+        auto count = chunk_begin(num_edges, chunk + 1) - chunk_begin(num_edges, chunk);
+        auto &edges = chunks[chunk];
+        edges.reserve(count);
+
+        for (long i=0; i < count; ++i) {
+            int u = 0, v = 0;
+            switch (_params.model) {
+                case GraphModel::RMAT:
+                    // Descend into one quadrant of the adjacency matrix per bit; ids past n are drawn again
+                    do {
+                        u = v = 0;
+                        for (int bit=0; bit < scale; ++bit) {
+                            auto r = ran3();
+                            if (r < _params.rmat_a) {}
+                            else if (r < _params.rmat_a + _params.rmat_b) v |= 1 << bit;
+                            else if (r < _params.rmat_a + _params.rmat_b + _params.rmat_c) u |= 1 << bit;
+                            else { u |= 1 << bit; v |= 1 << bit; }
+                        }
+                    } while (u >= n or v >= n);
+                    break;
+                case GraphModel::PLANTED_COVER:
+                    u = _permutation[int(ran3(_params.cover_size))];
+                    v = _permutation[int(ran3(n))];
+                    break;
+                default:
+                    u = int(ran3(n)); v = int(ran3(n));
+                    break;
+            }
+            if (u != v) edges.emplace_back(std::min(u, v), std::max(u, v));
+        }
+    });
+
+    EdgeList edges;
+    for (auto &chunk : chunks) edges.insert(edges.end(), chunk.begin(), chunk.end());
+    return edges;
+}
+
+GraphGenerator::EdgeList GraphGenerator::barabasi_albert_edges() const {
+    // Preferential attachment is inherently sequential: each new vertex picks its neighbours from a list holding
+    // every vertex once per incident edge, seeded with a clique on the first attachment+1 vertices
+    Random ran3(chunk_seed(_params.rand_seed, 0, 0));
+    auto n = _params.num_vertices, m = _params.attachment;
+    EdgeList edges;
+    vector<int> endpoints;
+    for (int u=0; u <= m and u < n; ++u) {
+        for (int v=u+1; v <= m and v < n; ++v) {
+            edges.emplace_back(u, v);
+            endpoints.emplace_back(u); endpoints.emplace_back(v);
+        }
+    }
+
+    set<int> targets;
+    for (int v=m+1; v < n; ++v) {
+        targets.clear();
+        while (int(targets.size()) < m) targets.insert(endpoints[int(ran3(endpoints.size()))]);
+        for (auto u : targets) {
+            edges.emplace_back(u, v);
+            endpoints.emplace_back(u); endpoints.emplace_back(v);
+        }
+    } return edges;
+}
+
+GraphGenerator::EdgeList GraphGenerator::geometric_edges(ThreadPool &pool) const {
+    // Points in the unit square, joined when closer than the radius; the expected edge count is n^2/2 * pi r^2
+    auto n = _params.num_vertices;
+    auto radius = (_params.radius > 0) ? _params.radius : std::sqrt(2.0 * _params.num_edges / (M_PI * double(n) * n));
+    vector<double> x(n), y(n);
+    pool.parallel_for(NUM_CHUNKS, [&](int chunk, int) {
+        Random ran3(chunk_seed(_params.rand_seed, 0, chunk));
+        for (auto i=chunk_begin(n, chunk); i < chunk_begin(n, chunk + 1); ++i) { x[i] = ran3(); y[i] = ran3(); }
+    });
+
+    // Bucket the points into square cells at least one radius wide, so neighbours are in the 3x3 block around a cell
+    auto cells_per_side = std::max(1, std::min(int(1.0 / radius), int(std::sqrt(double(n))) + 1));
+    auto cell_of = [&](int i) {
+        return std::min(cells_per_side - 1, int(y[i] * cells_per_side)) * cells_per_side + std::min(cells_per_side - 1, int(x[i] * cells_per_side));
+    };
+    vector<int> cell_start(cells_per_side * cells_per_side + 1, 0), points(n);
+    for (int i=0; i < n; ++i) cell_start[cell_of(i) + 1]++;
+    for (auto c=1U; c < cell_start.size(); ++c) cell_start[c] += cell_start[c - 1];
+    {
+        auto position = cell_start;
+        for (int i=0; i < n; ++i) points[position[cell_of(i)]++] = i;
+    }
+
+    vector<EdgeList> chunks(NUM_CHUNKS);
+    auto num_cells = long(cells_per_side) * cells_per_side;
+    pool.parallel_for(NUM_CHUNKS, [&](int chunk, int) {
+        for (auto cell=chunk_begin(num_cells, chunk); cell < chunk_begin(num_cells, chunk + 1); ++cell) {
+            int cx = cell % cells_per_side, cy = cell / cells_per_side;
+            for (int dy=-1; dy <= 1; ++dy) {
+                for (int dx=-1; dx <= 1; ++dx) {
+                    int nx = cx + dx, ny = cy + dy;
+                    if (nx < 0 or ny < 0 or nx >= cells_per_side or ny >= cells_per_side) continue;
+                    auto other = ny * cells_per_side + nx;
+                    for (auto a=cell_start[cell]; a < cell_start[cell + 1]; ++a) {
+                        for (auto b=cell_start[other]; b < cell_start[other + 1]; ++b) {
+                            auto u = points[a], v = points[b];
+                            auto ddx = x[u] - x[v], ddy = y[u] - y[v];
+                            if (u < v and ddx*ddx + ddy*ddy < radius*radius) chunks[chunk].emplace_back(u, v);
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    EdgeList edges;
+    for (auto &chunk : chunks) edges.insert(edges.end(), chunk.begin(), chunk.end());
+    return edges;
+}
+
+GraphGenerator::EdgeList GraphGenerator::planted_matching() {
+    // A random permutation: its first cover_size vertices form the cover, and each is matched to one of the next
+    // cover_size vertices, so any cover needs at least cover_size vertices
+    Random ran3(chunk_seed(_params.rand_seed, 0, 0));
+    auto n = _params.num_vertices, k = _params.cover_size;
+    _permutation.resize(n);
+    for (int i=0; i < n; ++i) _permutation[i] = i;
+    for (int i=n-1; i > 0; --i) std::swap(_permutation[i], _permutation[int(ran3(i + 1))]);
+
+    _planted_cover.assign(_permutation.begin(), _permutation.begin() + k);
+    std::sort(_planted_cover.begin(), _planted_cover.end());
+
+    EdgeList edges;
+    for (int i=0; i < k; ++i) edges.emplace_back(std::min(_permutation[i], _permutation[k + i]), std::max(_permutation[i], _permutation[k + i]));
+    return edges;
+}
+
+void GraphGenerator::merge(ThreadPool &pool, RawMetisFile &file, const RawMetisFile &extra) const {
+    auto n = _params.num_vertices;
+    pool.parallel_for(NUM_CHUNKS, [&](int chunk, int) {
+        for (auto v=chunk_begin(n, chunk); v < chunk_begin(n, chunk + 1); ++v) {
+            if (extra.Connections[v].empty()) continue;
+            auto &row = file.Connections[v];
+            auto middle = row.size();
+            row.insert(row.end(), extra.Connections[v].begin(), extra.Connections[v].end());
+            std::inplace_merge(row.begin(), row.begin() + middle, row.end());
+            row.erase(std::unique(row.begin(), row.end()), row.end());
+        }
+    });
+}
+
+RawMetisFile GraphGenerator::generate() {
+    ThreadPool pool( (_params.num_threads > 0) ? _params.num_threads : ThreadPool::hardware_threads() );
+
+    EdgeList edges;
+    switch (_params.model) {
+        case GraphModel::BARABASI_ALBERT:   return RawMetisFile::from_edges(_params.num_vertices, barabasi_albert_edges(), _params.num_threads);
+        case GraphModel::GEOMETRIC:         return RawMetisFile::from_edges(_params.num_vertices, geometric_edges(pool), _params.num_threads);
+        case GraphModel::PLANTED_COVER:     edges = planted_matching(); break;
+        default:                            break;
+    }
+
+    // Draw edges until num_edges of them are distinct; each round draws only as many as are missing, so it never
+    // overshoots, and is merged into the rows built so far (rounds are numbered from 1, as round 0 seeds the
+    // permutations and points above)
+    auto extra = sample_edges(pool, _params.num_edges - long(edges.size()), 1);
+    edges.insert(edges.end(), extra.begin(), extra.end());
+    auto file = RawMetisFile::from_edges(_params.num_vertices, edges, _params.num_threads);
+    EdgeList().swap(edges);
+    for (int round=2; file.num_edges() < _params.num_edges and round <= MAX_TOP_UP_ROUNDS; ++round) {
+        merge(pool, file, RawMetisFile::from_edges(_params.num_vertices, sample_edges(pool, _params.num_edges - file.num_edges(), round), _params.num_threads));
+    } return file;
+}
@@ -0,0 +1,59 @@
+#ifndef CSE6140_GRAPH_GENERATOR_
+#define CSE6140_GRAPH_GENERATOR_
+
+#include "RawMetisFile.h"
+#include "ThreadPool.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+enum class GraphModel { ERDOS_RENYI, BARABASI_ALBERT, RMAT, GEOMETRIC, PLANTED_COVER };
+
+struct GeneratorParameters {
+    GraphModel      model               = GraphModel::ERDOS_RENYI;
+    int             num_vertices        = 1000;
+    long            num_edges           = 4000;     // ERDOS_RENYI, RMAT, PLANTED_COVER; GEOMETRIC if radius is 0
+    int             attachment          = 4;        // BARABASI_ALBERT only: edges added with each new vertex
+    double          rmat_a              = 0.57;     // RMAT only: quadrant probabilities (d = 1 - a - b - c)
+    double          rmat_b              = 0.19;
+    double          rmat_c              = 0.19;
+    double          radius              = 0;        // GEOMETRIC only: connection radius in the unit square (0: chosen from num_edges)
+    int             cover_size          = 0;        // PLANTED_COVER only: size of the planted optimum (0: num_vertices / 4)
+    int             rand_seed           = 42;
+    int             num_threads         = 0;        // 0: all cores
+
+    static GraphModel parse_model(const std::string &name);
+    static std::string model_name(GraphModel model);
+};
+
+/*
+    Random graph generators for scaling experiments.  The work is split into a fixed number of chunks, each with its
+    own random stream derived from the seed, so the same parameters give the same graph whatever the thread count.
+    Duplicate edges and self-loops are dropped, and ERDOS_RENYI/RMAT/PLANTED_COVER are topped up until num_edges
+    distinct edges exist (RMAT gives up after a few rounds, as its edges concentrate on a few vertices).
+
+    PLANTED_COVER hides a vertex cover C of size cover_size: every edge has an endpoint in C, and C is matched to
+    cover_size other vertices, so no smaller cover exists and planted_cover() is optimal.
+*/
+class GraphGenerator {
+    typedef std::vector<std::pair<int,int>> EdgeList;
+
+    GeneratorParameters     _params;
+    std::vector<int>        _permutation;
+    std::vector<int>        _planted_cover;
+
+    EdgeList sample_edges(ThreadPool &pool, long num_edges, int round) const;
+    EdgeList barabasi_albert_edges() const;
+    EdgeList geometric_edges(ThreadPool &pool) const;
+    EdgeList planted_matching();
+    void merge(ThreadPool &pool, RawMetisFile &file, const RawMetisFile &extra) const;
+
+  public:
+    static const int NUM_CHUNKS = 256;
+
+    GraphGenerator(const GeneratorParameters &params);
+    RawMetisFile generate();
+    const std::vector<int>& planted_cover() const;
+};
+
+#endif
@@ -0,0 +1,35 @@
+/*
+GraphReduction.cpp: This module runs the LP and small-component reductions ahead of the metaheuristics, and composes their vertex mappings
+*/
+#include "GraphReduction.h"
+#include "ComponentDecomposition.h"
+#include "VertexCoverLP.h"
+
+using namespace std;
+
+ReducedGraph reduce_graph(GraphHandle graph, VertexMapping mapping, bool lp_reduction, int max_exact_component, ostream &log, const string &prefix) {
+    ReducedGraph reduced { std::move(graph), std::move(mapping) };
+    if (lp_reduction) {
+        // Nemhauser-Trotter: fix the vertices the LP relaxation sets to 1 or 0 and keep the half-integral rest
+        if (reduced.graph->is_weighted()) log << prefix << "LP reduction is not supported on weighted graphs; skipped" << endl;
+        else {
+            LPReduction reduction(*reduced.graph);
+            reduced.graph = std::make_shared<EdgeDenotedGraph>( reduction.mapping.apply(reduced.graph->to_metis_file()), false );
+            reduced.mapping = reduced.mapping.then(reduction.mapping);
+            log << prefix << "LP lower bound " << reduction.lower_bound << "; fixed " << reduction.num_in_cover << " vertices in the cover and "
+                << reduction.num_excluded << " out of it; " << reduced.graph->num_vertices() << " vertices left" << endl;
+        }
+    }
+    if (max_exact_component > 0) {
+        // Solve the small connected components exactly and keep the rest
+        if (reduced.graph->is_weighted()) log << prefix << "Exact component solving is not supported on weighted graphs; skipped" << endl;
+        else {
+            ComponentDecomposition decomposition(*reduced.graph, max_exact_component);
+            reduced.graph = std::make_shared<EdgeDenotedGraph>( decomposition.mapping.apply(reduced.graph->to_metis_file()), false );
+            reduced.mapping = reduced.mapping.then(decomposition.mapping);
+            log << prefix << "Solved " << decomposition.num_solved << " of " << decomposition.num_components << " components exactly ("
+                << decomposition.mapping.fixed_cover.size() << " cover vertices); " << reduced.graph->num_vertices() << " vertices left" << endl;
+        }
+    }
+    return reduced;
+}
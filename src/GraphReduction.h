@@ -0,0 +1,24 @@
+#ifndef CSE6140_GRAPH_REDUCTION_
+#define CSE6140_GRAPH_REDUCTION_
+
+#include "EdgeDenotedGraph.h"
+#include "VertexOrdering.h"
+#include <ostream>
+#include <string>
+
+/*
+    The reductions GA and ISING can run on a graph before init: the Nemhauser-Trotter LP reduction, then exact
+    solving of the connected components of at most max_exact_component vertices (0 skips it).  reduce_graph returns
+    the graph left to search, and mapping followed by the mappings of the reductions, so that covers of the reduced
+    graph map back to the input graph's ids.  Neither reduction takes vertex weights into account, so a weighted graph
+    is returned as it is.  Progress goes to log, one line per reduction, each starting with prefix.
+*/
+struct ReducedGraph {
+    GraphHandle     graph;
+    VertexMapping   mapping;
+};
+
+ReducedGraph reduce_graph(GraphHandle graph, VertexMapping mapping, bool lp_reduction, int max_exact_component,
+                          std::ostream &log, const std::string &prefix);
+
+#endif
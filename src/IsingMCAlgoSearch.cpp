@@ -3,85 +3,531 @@ IsingMCAlgoSearch.cpp: This module contains the routines for IMMC.  The routines
 */
 #include "IsingMCAlgoSearch.h"
 #include "Utilities.h"
+#include "GraphReduction.h"
+#include <cmath>
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 
 using namespace std;
 
+IsingKernel parse_kernel(const string &name) {
+    if (name == "metropolis")       return IsingKernel::METROPOLIS;
+    if (name == "sequential")       return IsingKernel::SEQUENTIAL_SWEEP;
+    if (name == "checkerboard")     return IsingKernel::CHECKERBOARD_SWEEP;
+    if (name == "rejection-free")   return IsingKernel::REJECTION_FREE;
+    if (name == "colored")          return IsingKernel::COLORED_PARALLEL;
+
+    cout << "[ ISING MC ALGORITHM ]: Unknown kernel '" << name << "'; expected one of [ metropolis, sequential, checkerboard, rejection-free, colored ]\n";
+    std::exit(-1);
+}
+
+string kernel_name(IsingKernel kernel) {
+    switch (kernel) {
+        case IsingKernel::METROPOLIS:           return "metropolis";
+        case IsingKernel::SEQUENTIAL_SWEEP:     return "sequential";
+        case IsingKernel::CHECKERBOARD_SWEEP:   return "checkerboard";
+        case IsingKernel::REJECTION_FREE:       return "rejection-free";
+        case IsingKernel::COLORED_PARALLEL:     return "colored";
+    } return "unknown";
+}
+
 IsingMCAlgoSearch::IsingMCAlgoSearch(const std::string &filepath) {
     _filepath = filepath;
-    _graph = EdgeDenotedGraph(filepath);
+    _graph = std::make_shared<EdgeDenotedGraph>(filepath, false);
+    _pool = std::make_shared<SolutionPool>();
+}
+
+IsingMCAlgoSearch::IsingMCAlgoSearch(const string &filepath, GraphHandle graph) {
+    // Reuse a graph that has already been loaded; filepath is only used to name the output files
+    _filepath = filepath;
+    _graph = std::move(graph);
+    _pool = std::make_shared<SolutionPool>();
+}
+
+IsingMCAlgoSearch::IsingMCAlgoSearch(const string &filepath, CompressedGraphHandle graph) {
+    // Anneals on a CompressedGraph (--compressed); only the Metropolis and sweep kernels, and no relabelling or
+    // reductions, are available on it
+    _filepath = filepath;
+    _compressed = std::move(graph);
+    _pool = std::make_shared<SolutionPool>();
+}
+
+template <typename F>
+auto IsingMCAlgoSearch::with_graph(F &&f) const -> decltype(f(std::declval<const EdgeDenotedGraph&>())) {
+    if (_compressed) return f(*_compressed);
+    return f(*_graph);
+}
+
+void IsingMCAlgoSearch::require_full_graph(const string &feature) const {
+    if (not _compressed) return;
+    cout << "[ ISING MC ALGORITHM ]: " << feature << " is not supported with --compressed" << endl;
+    std::exit(-1);
 }
 
+int IsingMCAlgoSearch::num_vertices() const {
+    return with_graph([](const auto &graph) { return graph.num_vertices(); });
+}
+
+void IsingMCAlgoSearch::set_solution_pool(shared_ptr<SolutionPool> pool) {
+    // Covers found are kept in this pool, which may be shared with other solvers on the same (relabelled, reduced) graph
+    _pool = std::move(pool);
+}
+
+void IsingMCAlgoSearch::set_output_directory(const string &directory) {
+    _output_directory = directory;
+}
+
+void IsingMCAlgoSearch::set_log_stream(std::ostream &log) {
+    // Where progress messages go (cout by default); solvers running side by side each need a stream of their own
+    _log = &log;
+}
+
+
+void IsingMCAlgoSearch::set_checkpoint(const string &path, double interval_sec) {
+    // Every interval_sec seconds of the run, snapshot the search and write it to path on a background thread
+    _checkpoint_writer.reset(new AsyncCheckpointWriter(path));
+    _checkpoint_interval_ms = std::max(0.0, interval_sec) * 1000.0;
+    *_log << "[ ISING MC ALGORITHM ]: Checkpointing to '" << path << "' every " << interval_sec << "s" << endl;
+}
+
+void IsingMCAlgoSearch::set_improvement_callback(ImprovementCallback callback) {
+    // Called with every new best cover, as it is written to the trace file
+    _on_improvement = std::move(callback);
+}
+
+void IsingMCAlgoSearch::set_cancellation(CancellationHandle token) {
+    // Checked every cycle alongside the time budget; a cancelled run stops and writes its best cover as at the cutoff
+    _cancellation = std::move(token);
+}
+
+void IsingMCAlgoSearch::write_checkpoint(int iteration) {
+    CheckpointWriter checkpoint("ISING");
+    checkpoint.put(_num_systems); checkpoint.put(_constant_A); checkpoint.put(_constant_B); checkpoint.put(_kernel); checkpoint.put(_num_threads);
+    checkpoint.put(iteration); checkpoint.put(stopwatch.elapsed_ms()); checkpoint.put(_best_cost);
+    checkpoint.put_random(ran3);
+    checkpoint.put_mapping(_mapping);
+    checkpoint.put_trace(_trace);
+    checkpoint.put_chromosome(_best);
+    checkpoint.put(uint64_t(Systems.size()));
+    for (auto i=0U; i < Systems.size(); ++i) { checkpoint.put_chromosome(Systems[i]); checkpoint.put(Schedules[i]); }
+    checkpoint.put_vector(SweepCursors);
+    checkpoint.put(uint64_t(ThreadRandoms.size()));
+    for (const auto &random : ThreadRandoms) checkpoint.put_random(random);
+    checkpoint.put(uint64_t(Kernels.size()));
+    for (const auto &kernel : Kernels) kernel.save(checkpoint);
+    _pool->save(checkpoint);
+    _checkpoint_writer->submit(std::move(checkpoint));
+}
+
+void IsingMCAlgoSearch::resume(const string &checkpoint_path) {
+    // Restores a search saved by set_checkpoint, in place of the reductions and init; run_for_ms then carries on from
+    // the checkpoint's iteration, elapsed time and temperatures, with the schedules' original time budget
+    CheckpointReader checkpoint(checkpoint_path, "ISING");
+    _num_systems        = checkpoint.get<int>();
+    _constant_A         = checkpoint.get<double>();
+    _constant_B         = checkpoint.get<double>();
+    _kernel             = checkpoint.get<IsingKernel>();
+    _num_threads        = checkpoint.get<int>();
+    _start_iteration    = checkpoint.get<int>();
+    _start_ms           = checkpoint.get<double>();
+    _best_cost          = checkpoint.get<int>();
+    ran3                = checkpoint.get_random();
+
+    auto mapping = checkpoint.get_mapping();
+    checkpoint.check(mapping.original_ids.empty() or int(mapping.new_ids.size()) == num_vertices(), "was written for a different graph");
+    if (not mapping.original_ids.empty()) require_full_graph("Resuming a relabelled or reduced search");
+    if (not mapping.original_ids.empty()) _graph = std::make_shared<EdgeDenotedGraph>( mapping.apply(_graph->to_metis_file()), false );
+    _mapping = std::move(mapping);
+    _trace = checkpoint.get_trace();
+    _best = checkpoint.get_chromosome();
+
+    Systems.resize( checkpoint.get<uint64_t>() ); Schedules.resize(Systems.size());
+    for (auto i=0U; i < Systems.size(); ++i) { Systems[i] = checkpoint.get_chromosome(); Schedules[i] = checkpoint.get<AnnealingSchedule>(); }
+    checkpoint.check(Systems.empty() or int(Systems[0].bitfield.size()) == num_vertices(), "was written for a different graph");
+    _resumed_cursors = checkpoint.get_vector<int>();
+    _resumed_randoms.resize( checkpoint.get<uint64_t>() );
+    for (auto &random : _resumed_randoms) random = checkpoint.get_random();
+    _resumed_kernels.resize( checkpoint.get<uint64_t>() );
+    checkpoint.check(_resumed_kernels.empty() or _resumed_kernels.size() == Systems.size(), "is malformed");
+    if (not _resumed_kernels.empty()) require_full_graph("The rejection-free kernel");
+    for (auto i=0U; i < _resumed_kernels.size(); ++i) {
+        _resumed_kernels[i].init(*_graph, Systems[i], _constant_A, _constant_B);
+        _resumed_kernels[i].load(checkpoint);
+    }
+    _pool->load(checkpoint);
+
+    *_log << "[ ISING MC ALGORITHM ]: Resuming '" << checkpoint_path << "' at cycle " << _start_iteration << " ("
+         << (_start_ms / 1000.0) << "s), best cover so far " << (_best_cost + _mapping.fixed_cover.size()) << endl;
+}
 
 void IsingMCAlgoSearch::init(int num_systems, int rand_seed) {
+    init(num_systems, AnnealingParameters(), 1, 100, rand_seed);
+}
+
+void IsingMCAlgoSearch::init(int num_systems, const AnnealingParameters &schedule, double constant_A, double constant_B, int rand_seed) {
     _num_systems    = num_systems;
+    _constant_A     = constant_A;
+    _constant_B     = constant_B;
     ran3            = Random(rand_seed);
 
-    // Initialize systems as full vertex-covers
-    best_solution_found_so_far = System::full_cover(_graph.num_vertices());
-    Systems.clear(); Systems.resize(num_systems, best_solution_found_so_far);
+    // Initialize systems as full vertex-covers, each with its own copy of the annealing schedule
+    with_graph([&](const auto &graph) {
+        _best = System::full_cover(graph);
+        _best_cost = _best.cover_weight;
+        Systems.clear(); Systems.resize(num_systems, _best);
+    });
+    Schedules.clear(); Schedules.resize(num_systems, AnnealingSchedule(schedule));
+
+    *_log << "[ ISING MC ALGORITHM ]: Initializing with the following parameters:\n"
+         << "filepath               = " << _filepath << "\n"
+         << "rand_seed              = " << rand_seed << "\n"
+         << "num_systems            = " << num_systems << "\n"
+         << "constant_A             = " << constant_A << "\n"
+         << "constant_B             = " << constant_B << "\n"
+         << "schedule               = " << AnnealingParameters::type_name(schedule.type) << "\n"
+         << "initial_temperature    = " << schedule.initial_temperature << "\n"
+         << "final_temperature      = " << schedule.final_temperature << "\n"
+         << "target_acceptance      = " << schedule.target_acceptance << "\n"
+         << "reheat_after_ms        = " << schedule.reheat_after_ms << "\n"
+         << "reheat_fraction        = " << schedule.reheat_fraction << "\n" << endl;
 }
 
 
-void IsingMCAlgoSearch::cycle(int iteration) {
-    for (auto &sys : Systems) {
-        auto bit_index = int( ran3(_graph.num_vertices()) );
-        auto marginal_edge_cost = _graph.incremental_edge_cost_of_bit_flip(sys.bitfield, bit_index);
-
-        // The difference in energy is the sum of the marginal cost of flipping the bit, plus the difference of 1 vertex added/removed
-        auto hamiltonian_diff = _constant_A * ((sys.bitfield[bit_index] == 0) ? 1.0 : -1.0 ) + _constant_B * double(marginal_edge_cost);
-
-        /*
-            Metropolis criterion - commence MC move with probability p = exp(-deltaE / kT)
-            We short circuit the case where deltaE < 0, since exp(<positive number>) > 1
-        */
-        auto beta = 3.0; // the Boltzmann temperature factor
-        if (hamiltonian_diff < 0 or ran3() < std::exp(-beta * hamiltonian_diff)) {
-            sys.update_with_bit_flip(_graph, bit_index);
+void IsingMCAlgoSearch::update_schedules() {
+    auto elapsed_ms = stopwatch.elapsed_ms();
+    for (auto &schedule : Schedules) schedule.update(elapsed_ms);
+}
+
+
+void IsingMCAlgoSearch::record_improvement(const System &sys) {
+    // Add the new best to the solution pool, log it in the trace file, and hold off any reheats
+    auto elapsed_ms = stopwatch.elapsed_ms();
+    _stats.count(Counter::SOLUTIONS_FOUND);
+    _pool->insert(sys);
+    _best = sys;
+    _best_cost = sys.cover_weight;
+    _trace.push_back({ elapsed_ms / 1000.0, _best_cost + int(_mapping.fixed_cover.size()) });
+    tracefile << _trace.back().time_sec << "," << _trace.back().cover_size << endl;
+    if (_on_improvement) _on_improvement({ "ISING", _trace.back().time_sec, _trace.back().cover_size });
+    for (auto &schedule : Schedules) schedule.record_improvement(elapsed_ms);
+}
+
+
+template <typename Graph, typename Weights>
+bool IsingMCAlgoSearch::metropolis_step(const Graph &graph, System &sys, AnnealingSchedule &schedule, int bit_index, const Weights &weights) {
+    auto marginal_edge_cost = graph.incremental_edge_cost_of_bit_flip(sys.bitfield, bit_index);
+
+    /*
+        The difference in energy is the sum of the marginal cost of flipping the bit, plus the difference of 1 vertex
+        added/removed.  On a weighted graph the vertex counts its weight over the largest weight, so A and B keep their
+        meaning (and B > A still makes every uncovered edge cost more than any vertex).
+    */
+    auto hamiltonian_diff = _constant_A * ((sys.bitfield[bit_index] == 0) ? 1.0 : -1.0 ) * weights.normalized(bit_index) + _constant_B * double(marginal_edge_cost);
+
+    /*
+        Metropolis criterion - commence MC move with probability p = exp(-deltaE / kT)
+        We short circuit the case where deltaE < 0, since exp(<positive number>) > 1
+        The Boltzmann temperature factor beta = 1/kT is supplied by the system's annealing schedule
+    */
+    auto accepted = hamiltonian_diff < 0 or ran3() < std::exp(-schedule.beta() * hamiltonian_diff);
+    if (accepted) sys.update_with_bit_flip(bit_index, marginal_edge_cost, weights);
+    schedule.record_move(accepted);
+    _stats.count(Counter::MOVES_PROPOSED);
+    if (accepted) _stats.count(Counter::MOVES_ACCEPTED);
+
+    // If the new solution is the best, record it
+    if (sys.is_vc and sys.cover_weight < _best_cost) record_improvement(sys);
+    return accepted;
+}
+
+
+template <typename Graph, typename Weights>
+void IsingMCAlgoSearch::cycle_metropolis(const Graph &graph, const Weights &weights) {
+    for (auto i=0U; i < Systems.size(); ++i) {
+        metropolis_step(graph, Systems[i], Schedules[i], int( ran3(graph.num_vertices()) ), weights);
+    }
+}
+
+
+int IsingMCAlgoSearch::sweep_position_to_vertex(int position, int num_vertices) const {
+    if (_kernel == IsingKernel::SEQUENTIAL_SWEEP) return position;
+
+    // Checkerboard: all even vertex ids, then all odd vertex ids
+    auto num_even = (num_vertices + 1) / 2;
+    return (position < num_even) ? 2*position : 2*(position - num_even) + 1;
+}
+
+
+template <typename Graph, typename Weights>
+void IsingMCAlgoSearch::cycle_sweep(const Graph &graph, const Weights &weights) {
+    /*
+        Visit the vertices in storage order rather than at random, so consecutive moves touch consecutive rows of the
+        adjacency lists and consecutive bits of the bitfield.  Each cycle advances every system by a block of moves.
+    */
+    const int block_size = 64;
+    auto num_vertices = graph.num_vertices();
+    for (auto i=0U; i < Systems.size(); ++i) {
+        auto &cursor = SweepCursors[i];
+        for (int move=0; move < block_size; ++move) {
+            metropolis_step(graph, Systems[i], Schedules[i], sweep_position_to_vertex(cursor, num_vertices), weights);
+            if (++cursor == num_vertices) cursor = 0;
         }
+    }
+}
+
+
+void IsingMCAlgoSearch::cycle_rejection_free() {
+    for (auto i=0U; i < Systems.size(); ++i) {
+        auto &sys = Systems[i]; auto &schedule = Schedules[i]; auto &kernel = Kernels[i];
+
+        // Every move drawn by the kernel is accepted; it stands in for `proposals` Metropolis proposals
+        double proposals = 1;
+        auto bit_index = kernel.select(ran3, schedule.beta(), proposals);
+        sys.update_with_bit_flip(bit_index, kernel.marginal_edge_cost(bit_index));
+        kernel.apply_flip(bit_index, sys.bitfield[bit_index]);
+        schedule.record_moves(proposals, 1);
+        _stats.count(Counter::MOVES_PROPOSED, (long long)proposals);
+        _stats.count(Counter::MOVES_ACCEPTED);
+
+        if (sys.is_vc and sys.cover_weight < _best_cost) record_improvement(sys);
+    }
+}
+
+
+template <typename Graph, typename Weights>
+void IsingMCAlgoSearch::cycle_colored_parallel(const Graph &graph, const Weights &weights) {
+    /*
+        One full sweep per cycle, one color class at a time.  Vertices of the same color share no edge, so the marginal
+        cost of each of their flips only reads bits of *other* colors, which stay fixed while the class is updated.
+        Each class is split into at most one chunk per thread; chunk k always draws from random stream k, so a run is
+        reproducible for a given seed and thread count.
+    */
+    const int min_chunk_size = 1024;
+    struct ChunkTally { std::uint64_t hash_diff; int filled_bits_diff, cover_weight_diff, uncovered_edges_diff, acceptances; char padding[40]; };
+    vector<ChunkTally> tallies(_thread_pool->num_threads());
 
-        // If the new solution is the best, copy it to best_solution_found_so_far and log it in the trace file
-        if (sys.is_vc and sys.filled_bits < best_solution_found_so_far.filled_bits) {
-            best_solution_found_so_far = sys;
-            tracefile << (stopwatch.elapsed_ms() / 1000.0) << "," << best_solution_found_so_far.filled_bits << endl;
+    for (auto i=0U; i < Systems.size(); ++i) {
+        auto &sys = Systems[i]; auto &schedule = Schedules[i];
+        auto beta = schedule.beta();
+
+        for (const auto &color_class : _coloring.color_classes) {
+            int class_size = color_class.size();
+            auto num_chunks = std::min(int(tallies.size()), (class_size + min_chunk_size - 1) / min_chunk_size);
+            for (auto &tally : tallies) { tally.hash_diff = 0; tally.filled_bits_diff = tally.cover_weight_diff = tally.uncovered_edges_diff = tally.acceptances = 0; }
+
+            _thread_pool->parallel_for(num_chunks, [&](int chunk, int) {
+                auto &rng = ThreadRandoms[chunk]; auto &tally = tallies[chunk];
+                auto end = int( (long(class_size) * (chunk+1)) / num_chunks );
+                for (auto k = int( (long(class_size) * chunk) / num_chunks ); k < end; ++k) {
+                    auto bit_index = color_class[k];
+                    auto marginal_edge_cost = graph.incremental_edge_cost_of_bit_flip(sys.bitfield, bit_index);
+                    auto hamiltonian_diff = _constant_A * ((sys.bitfield[bit_index] == 0) ? 1.0 : -1.0 ) * weights.normalized(bit_index) + _constant_B * double(marginal_edge_cost);
+
+                    if (hamiltonian_diff < 0 or rng() < std::exp(-beta * hamiltonian_diff)) {
+                        tally.filled_bits_diff      += (sys.bitfield[bit_index] == 0) ? 1 : -1;
+                        tally.cover_weight_diff     += (sys.bitfield[bit_index] == 0) ? weights[bit_index] : -weights[bit_index];
+                        tally.uncovered_edges_diff  += marginal_edge_cost;
+                        tally.acceptances++;
+                        tally.hash_diff             ^= System::bit_key(bit_index);
+                        sys.bitfield[bit_index] = (sys.bitfield[bit_index] == 0) ? 1 : 0;
+                    }
+                }
+            });
+
+            auto acceptances = 0;
+            for (const auto &tally : tallies) {
+                sys.hash            ^= tally.hash_diff;
+                sys.filled_bits     += tally.filled_bits_diff;
+                sys.cover_weight    += tally.cover_weight_diff;
+                sys.uncovered_edges += tally.uncovered_edges_diff;
+                acceptances         += tally.acceptances;
+            }
+            sys.is_vc = (sys.uncovered_edges == 0);
+            schedule.record_moves(class_size, acceptances);
+            _stats.count(Counter::MOVES_PROPOSED, class_size);
+            _stats.count(Counter::MOVES_ACCEPTED, acceptances);
+
+            if (sys.is_vc and sys.cover_weight < _best_cost) record_improvement(sys);
         }
     }
 }
 
 
+void IsingMCAlgoSearch::cycle(int iteration) {
+    // Reading the clock is not free, so the time-driven schedules are only advanced every so often (every full sweep for the colored kernel)
+    if (iteration % 256 == 0 or _kernel == IsingKernel::COLORED_PARALLEL) update_schedules();
+    SolverStats::ScopedCycles timer(_stats, Phase::KERNEL);
+
+    // The kernels are compiled once per graph type and weight policy; only those are picked here
+    with_graph([&](const auto &graph) {
+        with_weight_policy(graph, [&](const auto &weights) {
+            switch (_kernel) {
+                case IsingKernel::METROPOLIS:           cycle_metropolis(graph, weights);  break;
+                case IsingKernel::SEQUENTIAL_SWEEP:
+                case IsingKernel::CHECKERBOARD_SWEEP:   cycle_sweep(graph, weights);       break;
+                case IsingKernel::REJECTION_FREE:       cycle_rejection_free();            break;
+                case IsingKernel::COLORED_PARALLEL:     cycle_colored_parallel(graph, weights); break;
+            }
+        });
+    });
+}
+
+
+void IsingMCAlgoSearch::set_kernel(IsingKernel kernel) {
+    // The rejection-free rates assume unit vertices, so weighted graphs fall back to Metropolis proposals
+    if (kernel == IsingKernel::REJECTION_FREE and not _compressed and _graph->is_weighted()) {
+        *_log << "[ ISING MC ALGORITHM ]: The rejection-free kernel is not supported on weighted graphs; using metropolis" << endl;
+        kernel = IsingKernel::METROPOLIS;
+    }
+    // Its rates and the coloring are built from EdgeDenotedGraph's edge lists, which a CompressedGraph does not keep
+    if ((kernel == IsingKernel::REJECTION_FREE or kernel == IsingKernel::COLORED_PARALLEL) and _compressed) {
+        *_log << "[ ISING MC ALGORITHM ]: The " << kernel_name(kernel) << " kernel is not supported with --compressed; using metropolis" << endl;
+        kernel = IsingKernel::METROPOLIS;
+    }
+    _kernel = kernel;
+}
+
+
+void IsingMCAlgoSearch::set_num_threads(int num_threads) {
+    _num_threads = (num_threads <= 0) ? ThreadPool::hardware_threads() : num_threads;
+}
+
+
+void IsingMCAlgoSearch::set_vertex_ordering(OrderingType ordering) {
+    // Relabel the graph so neighbouring vertices are stored near each other; solutions are mapped back on output
+    require_full_graph("Vertex ordering");
+    auto ordering_mapping = VertexMapping(*_graph, ordering);
+    if (not ordering_mapping.is_identity()) _graph = std::make_shared<EdgeDenotedGraph>( ordering_mapping.apply(_graph->to_metis_file()), false );
+    _mapping = _mapping.then(ordering_mapping);
+    *_log << "[ ISING MC ALGORITHM ]: Using vertex ordering '" << VertexMapping::type_name(ordering) << "'" << endl;
+}
+
+void IsingMCAlgoSearch::apply_reductions(bool lp_reduction, int max_exact_component) {
+    // See reduce_graph(); call before init
+    if (not lp_reduction and max_exact_component == 0) return;
+    require_full_graph("Graph reduction");
+    auto reduced = reduce_graph(_graph, _mapping, lp_reduction, max_exact_component, *_log, "[ ISING MC ALGORITHM ]: ");
+    _graph = std::move(reduced.graph);
+    _mapping = std::move(reduced.mapping);
+}
+
+
+void IsingMCAlgoSearch::prepare_kernel() {
+    SolverStats::ScopedPhase timer(_stats, Phase::INITIALIZATION);
+    SweepCursors.assign(Systems.size(), 0);
+    if (_kernel == IsingKernel::COLORED_PARALLEL or _kernel == IsingKernel::REJECTION_FREE) require_full_graph("The " + kernel_name(_kernel) + " kernel");
+    if (_kernel == IsingKernel::COLORED_PARALLEL) {
+        _coloring = GraphColoring(*_graph);
+        _thread_pool.reset(new ThreadPool(_num_threads));
+        ThreadRandoms.clear();
+        for (int t=0; t < _num_threads; ++t) ThreadRandoms.emplace_back( Random(ran3.seed() + 7919*(t+1)) );
+        *_log << "[ ISING MC ALGORITHM ]: Greedy coloring found " << _coloring.num_colors() << " color classes; sweeping with "
+             << _num_threads << " threads" << endl;
+    }
+    if (_kernel == IsingKernel::REJECTION_FREE) {
+        Kernels.resize(Systems.size());
+        for (auto i=0U; i < Systems.size(); ++i) Kernels[i].init(*_graph, Systems[i], _constant_A, _constant_B);
+    }
+}
+
+
 int IsingMCAlgoSearch::run_for_ms(double milliseconds, bool verbose) {
     milliseconds = std::abs(milliseconds);
-    cout << "[ ISING MC ALGORITHM ]: Running algorithm for target " << (milliseconds/1000.0) << "s..." << endl;
+    *_log << "[ ISING MC ALGORITHM ]: Running algorithm for target " << (milliseconds/1000.0) << "s with the " << kernel_name(_kernel) << " kernel..." << endl;
 
-    // Open tracefile
-    tracefile = std::ofstream( generate_trace_filepath(_filepath, "ISING", milliseconds/1000.0, ran3.seed()).c_str(), std::ofstream::out );
+    // Open tracefile (a resumed run rewrites the points from before its checkpoint)
+    tracefile = std::ofstream( join_path(_output_directory, generate_trace_filepath(_filepath, "ISING", milliseconds/1000.0, ran3.seed())).c_str(), std::ofstream::out );
+    if (_start_iteration == 0) _trace.clear();
     tracefile.sync_with_stdio(false);
+    for (const auto &point : _trace) tracefile << point.time_sec << "," << point.cover_size << endl;
 
-    //　Run ISING-MC
-    stopwatch.reset(); auto iteration=0;
-    while (++iteration, stopwatch.elapsed_ms() < milliseconds) {
-        if (verbose) cout << "[ ISING MC ALGORITHM ] CYCLING (" << iteration << ")" << endl;
-        cycle(iteration);
+    //　Run ISING-MC, annealing over the full time budget
+    if (_start_iteration == 0) for (auto &schedule : Schedules) schedule.start(milliseconds);
+    prepare_kernel();
+    if (_resumed_cursors.size() == SweepCursors.size()) SweepCursors.swap(_resumed_cursors);
+    if (_resumed_randoms.size() == ThreadRandoms.size()) ThreadRandoms.swap(_resumed_randoms);
+    if (_resumed_kernels.size() == Kernels.size()) Kernels.swap(_resumed_kernels);
+    _resumed_cursors.clear(); _resumed_randoms.clear(); _resumed_kernels.clear();
+    stopwatch.reset(_start_ms); auto iteration=_start_iteration;
+    auto next_checkpoint_ms = _start_ms + _checkpoint_interval_ms;
+    {
+        SolverStats::ScopedPhase timer(_stats, Phase::SEARCH);
+        while (++iteration, stopwatch.elapsed_ms() < milliseconds and not is_cancelled(_cancellation)) {
+            if (verbose) *_log << "[ ISING MC ALGORITHM ] CYCLING (" << iteration << ")" << endl;
+            cycle(iteration);
+            if (_checkpoint_writer and stopwatch.elapsed_ms() >= next_checkpoint_ms) {
+                write_checkpoint(iteration);
+                next_checkpoint_ms = stopwatch.elapsed_ms() + _checkpoint_interval_ms;
+            }
+        }
     }
+    if (_checkpoint_writer) _checkpoint_writer->flush();
 
-    cout << "[ ISING MC ALGORITHM ]: Finished running " << iteration << " cycles in approximately " << (stopwatch.elapsed_ms()/1000.0) << "s" << endl;
+    if (is_cancelled(_cancellation)) *_log << "[ ISING MC ALGORITHM ]: Cancelled" << endl;
+    *_log << "[ ISING MC ALGORITHM ]: Finished running " << iteration << " cycles in approximately " << (stopwatch.elapsed_ms()/1000.0) << "s" << endl;
+    for (auto i=0U; i < Schedules.size(); ++i) {
+        *_log << "[ ISING MC ALGORITHM ]: System " << i << " ended at temperature " << Schedules[i].temperature()
+             << " after " << Schedules[i].num_reheats() << " reheats" << endl;
+    }
+    if (_kernel == IsingKernel::REJECTION_FREE) {
+        double simulated_steps = 0;
+        for (const auto &kernel : Kernels) simulated_steps += kernel.simulated_steps();
+        *_log << "[ ISING MC ALGORITHM ]: Rejection-free kernel simulated " << simulated_steps << " Metropolis proposals ("
+             << (simulated_steps / num_vertices()) << " sweeps)" << endl;
+    }
 
-    auto solution_filepath = generate_solution_filepath(_filepath, "ISING", milliseconds/1000.0, ran3.seed());
-    cout << "[ ISING MC ALGORITHM ]: Writing best solution found to file '" << solution_filepath << "'" << endl;
-    best_solution_found_so_far.write_solution_to_file(solution_filepath);
+    auto solution_filepath = join_path(_output_directory, generate_solution_filepath(_filepath, "ISING", milliseconds/1000.0, ran3.seed()));
+    *_log << "[ ISING MC ALGORITHM ]: Writing best solution found to file '" << solution_filepath << "'" << endl;
+    // Written using the original vertex ids (and the input file's own ids, if it had any)
+    const auto &graph_ids = with_graph([](const auto &graph) -> const std::vector<long>& { return graph.original_ids(); });
+    best_solution().write_solution_to_file(solution_filepath, _mapping.original_ids.empty() ? graph_ids : _mapping.input_ids);
 
     return iteration;
 
 }
 
-EdgeDenotedGraph IsingMCAlgoSearch::graph() {
-    return _graph;
+void IsingMCAlgoSearch::step(int num_cycles) {
+    // Runs cycles without a time budget or output files (used for benchmarking)
+    if (SweepCursors.size() != Systems.size()) {
+        for (auto &schedule : Schedules) schedule.start(0);
+        prepare_kernel();
+    }
+    for (int iteration=1; iteration <= num_cycles; ++iteration) cycle(iteration);
 }
 
-std::vector<System> IsingMCAlgoSearch::systems() {
+const EdgeDenotedGraph& IsingMCAlgoSearch::graph() const {
+    require_full_graph("graph()");
+    return *_graph;
+}
+
+const std::vector<System>& IsingMCAlgoSearch::systems() const {
     return Systems;
 }
 
+const SolverStats& IsingMCAlgoSearch::statistics() const {
+    return _stats;
+}
+
+Chromosome IsingMCAlgoSearch::best_solution() const {
+    // In the input graph's vertex ids, whatever relabelling or reduction the search ran on
+    auto solution = _best;
+    if (_mapping.original_ids.empty()) return solution;
+    solution.bitfield = _mapping.to_original(solution.bitfield);
+    solution.filled_bits += _mapping.fixed_cover.size();
+    solution.cover_weight += _mapping.fixed_cover.size();
+    solution.rehash();
+    return solution;
+}
+
+const SolutionPool& IsingMCAlgoSearch::solution_pool() const {
+    return *_pool;
+}
+
+const std::vector<TracePoint>& IsingMCAlgoSearch::trace() const {
+    return _trace;
+}
+
 void IsingMCAlgoSearch::print_systems() const {
     cout << "[ ISING SYSTEMS ]\n";
     int count=0;
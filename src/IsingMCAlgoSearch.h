@@ -2,39 +2,119 @@
 #define ISING_MC_ALGO_SEARCH_H_
 
 #include "EdgeDenotedGraph.h"
+#include "CompressedGraph.h"
 #include "Chromosome.h"
 #include "Random.h"
 #include "Stopwatch.h"
+#include "SolverStats.h"
+#include "Utilities.h"
+#include "AnnealingSchedule.h"
+#include "RejectionFreeKernel.h"
+#include "VertexOrdering.h"
+#include "SolutionPool.h"
+#include "Checkpoint.h"
+#include "SolverEvents.h"
+#include "GraphColoring.h"
+#include "ThreadPool.h"
 #include <vector>
 #include <fstream>
+#include <iostream>
+#include <memory>
 
 typedef Chromosome System;
 
+enum class IsingKernel { METROPOLIS, SEQUENTIAL_SWEEP, CHECKERBOARD_SWEEP, REJECTION_FREE, COLORED_PARALLEL };
+IsingKernel parse_kernel(const std::string &name);
+std::string kernel_name(IsingKernel kernel);
+
 class IsingMCAlgoSearch {
 private:
     Random                      ran3;
     Stopwatch                   stopwatch;
     std::ofstream               tracefile;
+    std::ostream                *_log       = &std::cout;
     std::string                 _filepath;
-    EdgeDenotedGraph            _graph;
+    std::string                 _output_directory;
+    GraphHandle                 _graph;
+    CompressedGraphHandle       _compressed;            // set instead of _graph by the CompressedGraph constructor
     std::vector<System>         Systems;
-    std::vector<double>         Temperatures;
-    System                      best_solution_found_so_far;
+    std::vector<AnnealingSchedule> Schedules;
+    std::vector<RejectionFreeKernel> Kernels;
+    std::vector<int>            SweepCursors;
+    VertexMapping               _mapping;
+    GraphColoring               _coloring;
+    std::unique_ptr<ThreadPool> _thread_pool;
+    std::vector<Random>         ThreadRandoms;
+    std::shared_ptr<SolutionPool> _pool;
+    int                         _best_cost;
+    Chromosome                  _best;                  // this search's own best cover, which best_solution() returns
+    std::vector<TracePoint>     _trace;
+    SolverStats                 _stats { "ISING" };
 
     int     _num_systems        = 0;
     double  _constant_A         = 1;
     double  _constant_B         = 100;
+    IsingKernel _kernel         = IsingKernel::METROPOLIS;
+    int     _num_threads        = 1;
+
+    // Observer of new best covers, and the token that stops the run early
+    ImprovementCallback         _on_improvement;
+    CancellationHandle          _cancellation;
+
+    // Periodic checkpoints, and where a resumed run picks up (the sweep cursors, thread streams and rejection-free
+    // kernels are restored once the kernel is prepared)
+    std::unique_ptr<AsyncCheckpointWriter> _checkpoint_writer;
+    double  _checkpoint_interval_ms = 0;
+    int     _start_iteration    = 0;
+    double  _start_ms           = 0;
+    std::vector<int>            _resumed_cursors;
+    std::vector<Random>         _resumed_randoms;
+    std::vector<RejectionFreeKernel> _resumed_kernels;
+
+    void update_schedules();
+    void record_improvement(const System &sys);
+    // The kernels that only need degrees and neighbor lists run on either graph type; with_graph picks the loaded one
+    template <typename F> auto with_graph(F &&f) const -> decltype(f(std::declval<const EdgeDenotedGraph&>()));
+    void require_full_graph(const std::string &feature) const;
+    int num_vertices() const;
 
+    template <typename Graph, typename Weights> bool metropolis_step(const Graph &graph, System &sys, AnnealingSchedule &schedule, int bit_index, const Weights &weights);
+    int sweep_position_to_vertex(int position, int num_vertices) const;
+    template <typename Graph, typename Weights> void cycle_metropolis(const Graph &graph, const Weights &weights);
+    template <typename Graph, typename Weights> void cycle_sweep(const Graph &graph, const Weights &weights);
+    void cycle_rejection_free();
+    template <typename Graph, typename Weights> void cycle_colored_parallel(const Graph &graph, const Weights &weights);
+    void prepare_kernel();
     void cycle(int iteration);
+    void write_checkpoint(int iteration);
 
 public:
     IsingMCAlgoSearch() = delete;
     IsingMCAlgoSearch(const std::string &filepath);
+    IsingMCAlgoSearch(const std::string &filepath, GraphHandle graph);
+    IsingMCAlgoSearch(const std::string &filepath, CompressedGraphHandle graph);
     void init(int num_systems, int rand_seed);
+    void init(int num_systems, const AnnealingParameters &schedule, double constant_A, double constant_B, int rand_seed);
+    void set_kernel(IsingKernel kernel);
+    void set_vertex_ordering(OrderingType ordering);
+    void apply_reductions(bool lp_reduction, int max_exact_component);
+    void set_num_threads(int num_threads);
+    void set_solution_pool(std::shared_ptr<SolutionPool> pool);
+    void set_output_directory(const std::string &directory);
+    void set_log_stream(std::ostream &log);
+    void set_checkpoint(const std::string &path, double interval_sec);
+    void set_improvement_callback(ImprovementCallback callback);
+    void set_cancellation(CancellationHandle token);
+    void resume(const std::string &checkpoint_path);
     int run_for_ms(double milliseconds, bool verbose=false);
-    EdgeDenotedGraph graph();
-    std::vector<Chromosome> systems();
+    void step(int num_cycles);
+    const EdgeDenotedGraph& graph() const;
+    const std::vector<Chromosome>& systems() const;
     void print_systems() const;
+    const SolverStats& statistics() const;
+    Chromosome best_solution() const;
+    const SolutionPool& solution_pool() const;
+    const std::vector<TracePoint>& trace() const;
 };
 
 #endif
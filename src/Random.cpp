@@ -3,6 +3,7 @@ Random.cpp: a basic random number generator that is initialized with a provided
 */
 #include "Random.h"
 #include <random>
+#include <sstream>
 
 Random::Random(int seed) {
 	_seed 		= seed;
@@ -25,3 +26,15 @@ double Random::operator()(double high) {
 double Random::operator()(double low, double high) {
     return dist(generator)*(high-low) + low;
 }
+
+std::string Random::state() const {
+	// The seed and the generator state as text (the standard only defines the engines' state in that form)
+	std::ostringstream oss;
+	oss << _seed << " " << generator << " " << dist;
+	return oss.str();
+}
+
+void Random::set_state(const std::string &state) {
+	std::istringstream iss(state);
+	iss >> _seed >> generator >> dist;
+}
@@ -2,6 +2,7 @@
 #define CSE6140_RANDOM_
 
 #include <random>
+#include <string>
 
 class Random {
 	int _seed = 0;
@@ -15,6 +16,8 @@ class Random {
     double operator()();
     double operator()(double high);
     double operator()(double low, double high);
+    std::string state() const;
+    void set_state(const std::string &state);
 };
 
 #endif
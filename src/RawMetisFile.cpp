@@ -2,46 +2,392 @@
 RawMetisFile.cpp: This module parses a metis file into RawMetisFile objects that contain a 2D vector of numbers.
 */
 #include "RawMetisFile.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <iterator>
 #include <fstream>
 #include <sstream>
 #include <memory>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
-RawMetisFile::RawMetisFile(const string &filepath) {
-    int num_vertices=0, num_edges=0, line_count=0;
-    std::string line;
-    ifstream ifs(filepath);
-    ifs.sync_with_stdio(false);
+namespace {
+    // Read-only view of a whole file; mapped where the platform allows it, otherwise read into memory
+    class FileView {
+        const char  *_data  = nullptr;
+        size_t      _size   = 0;
+        std::string _buffer;
+#if defined(__unix__) || defined(__APPLE__)
+        bool        _mapped = false;
+#endif
+
+      public:
+        FileView(const string &filepath) {
+#if defined(__unix__) || defined(__APPLE__)
+            auto fd = open(filepath.c_str(), O_RDONLY);
+            struct stat st;
+            if (fd >= 0 and fstat(fd, &st) == 0 and st.st_size > 0) {
+                auto data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED) {
+                    madvise(data, st.st_size, MADV_SEQUENTIAL);
+                    _data = static_cast<const char*>(data); _size = st.st_size; _mapped = true;
+                }
+            }
+            if (fd >= 0) close(fd);
+            if (_mapped) return;
+#endif
+            ifstream ifs(filepath, ifstream::binary);
+            _buffer.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+            _data = _buffer.data(); _size = _buffer.size();
+        }
+
+        ~FileView() {
+#if defined(__unix__) || defined(__APPLE__)
+            if (_mapped) munmap(const_cast<char*>(_data), _size);
+#endif
+        }
+
+        FileView(const FileView&) = delete;
+        FileView& operator=(const FileView&) = delete;
+        const char* begin() const { return _data; }
+        const char* end() const { return _data + _size; }
+    };
+
+    const char* next_line(const char *p, const char *end) {
+        auto newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        return newline ? newline + 1 : end;
+    }
+
+    // Parses the unsigned integers on one line, skipping any other characters (spaces, tabs, '\r')
+    template <typename Callback>
+    void parse_integers(const char *p, const char *end, Callback callback) {
+        while (p < end) {
+            while (p < end and (*p < '0' or *p > '9')) ++p;
+            if (p == end) break;
+            long value = 0;
+            while (p < end and *p >= '0' and *p <= '9') value = value * 10 + (*p++ - '0');
+            callback(value);
+        }
+    }
+
+    // Parses at most count unsigned integers from the start of a line into values, returning how many were found
+    int parse_first_integers(const char *p, const char *end, long *values, int count) {
+        int found = 0;
+        while (p < end and found < count) {
+            while (p < end and *p != '\n' and (*p < '0' or *p > '9')) ++p;
+            if (p == end or *p == '\n') break;
+            long value = 0;
+            while (p < end and *p >= '0' and *p <= '9') value = value * 10 + (*p++ - '0');
+            values[found++] = value;
+        } return found;
+    }
+
+    // Splits [body, end) into num_chunks byte ranges that each start at the beginning of a line
+    vector<const char*> split_lines(const char *body, const char *end, int num_chunks) {
+        vector<const char*> chunk_starts(num_chunks + 1, end);
+        chunk_starts[0] = body;
+        for (int c=1; c < num_chunks; ++c) {
+            auto target = body + (end - body) * c / num_chunks;
+            chunk_starts[c] = std::max(chunk_starts[c - 1], (target == body) ? body : next_line(target - 1, end));
+        } return chunk_starts;
+    }
+
+    // About 64KB per chunk and 8 chunks per thread; small files are not worth starting any threads for
+    int num_chunks_for(const char *body, const char *end, int &num_threads) {
+        if (num_threads <= 0) num_threads = ThreadPool::hardware_threads();
+        auto num_chunks = std::max(1, int(std::min<long>(num_threads * 8, (end - body) / (1 << 16))));
+        num_threads = std::min(num_threads, num_chunks);
+        return num_chunks;
+    }
+
+    bool ends_with(const string &s, const string &suffix) {
+        return s.size() >= suffix.size() and s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    // Appends the decimal digits of value (non-negative) to out, returning the new end
+    char* format_integer(char *out, unsigned value) {
+        char digits[10]; int n = 0;
+        do { digits[n++] = char('0' + value % 10); value /= 10; } while (value);
+        while (n) *out++ = digits[--n];
+        return out;
+    }
+}
+
+RawMetisFile::RawMetisFile(const string &filepath, int num_threads) {
+    read_metis_rows(filepath, num_threads,
+        [&](int num_vertices, bool is_weighted, const vector<int>&) {
+            Connections.resize(num_vertices);
+            if (is_weighted) VertexWeights.assign(num_vertices, 1);
+        },
+        [&](int, int vertex, vector<int> &neighbors, int weight) {
+            Connections[vertex].swap(neighbors);
+            if (not VertexWeights.empty()) VertexWeights[vertex] = weight;
+        });
+}
+
+void RawMetisFile::read_metis_rows(const string &filepath, int num_threads, const LayoutCallback &layout, const RowCallback &row) {
+    FileView file(filepath);
+    auto p = file.begin(), end = file.end();
+    while (p < end and *p == '%') p = next_line(p, end);
 
     // Parse first line of file for number of vertices and edges
-    std::getline(ifs, line);
-    std::istringstream iss_first_line(line);
-    if (not (iss_first_line >> num_vertices >> num_edges)) {
+    vector<long> header;
+    auto body = next_line(p, end);
+    parse_integers(p, body, [&](long value) { header.emplace_back(value); });
+    if (header.size() < 2) {
         cout << "[RawMetisFile] First line of file does not contain two integers!\n";
         std::exit(-1);
     }
+    auto num_vertices = int(header[0]);
 
-    // Parse the rest of the file
-    while (std::getline(ifs, line) and line_count++ < num_vertices) {
-        vector<int> row;
-        int tmp, token_count=0;
+    // fmt is read as three binary digits: vertex sizes (ignored), vertex weights, edge weights
+    auto fmt = (header.size() > 2) ? header[2] : 0;
+    auto has_sizes = (fmt / 100) % 10 != 0, has_vertex_weights = (fmt / 10) % 10 != 0, has_edge_weights = fmt % 10 != 0;
+    auto num_weights = has_vertex_weights ? ((header.size() > 3) ? int(header[3]) : 1) : 0;
+    if (fmt > 111 or (fmt % 10) > 1 or (fmt / 10) % 10 > 1 or num_weights < 0) {
+        cout << "[RawMetisFile] Unsupported fmt '" << fmt << "' in the first line of file!\n";
+        std::exit(-1);
+    }
+
+    // Split the rest into byte ranges and count the vertex lines in each; a prefix sum over the counts gives the
+    // vertex id of each range's first line
+    auto num_chunks = num_chunks_for(body, end, num_threads);
+    ThreadPool pool(num_threads);
+    auto chunk_starts = split_lines(body, end, num_chunks);
 
-        // NOTE that the internal representation of the graph is 0-based, while the METIS output is 1-based
-        std::istringstream iss(line);
-        while ((iss >> tmp) and ++token_count < num_edges) { row.emplace_back(tmp-1); }
+    vector<int> first_vertex(num_chunks + 1, 0);
+    pool.parallel_for(num_chunks, [&](int c, int) {
+        int lines = 0;
+        for (auto line = chunk_starts[c]; line < chunk_starts[c + 1]; line = next_line(line, end)) if (*line != '%') lines++;
+        first_vertex[c + 1] = lines;
+    });
+    for (int c=0; c < num_chunks; ++c) first_vertex[c + 1] += first_vertex[c];
+    num_vertices = std::min(num_vertices, first_vertex[num_chunks]);
+    for (auto &vertex : first_vertex) vertex = std::min(vertex, num_vertices);
+    layout(num_vertices, has_vertex_weights, first_vertex);
+
+    pool.parallel_for(num_chunks, [&](int c, int) {
+        auto vertex = first_vertex[c];
+        vector<int> neighbors;
+        for (auto line = chunk_starts[c]; line < chunk_starts[c + 1] and vertex < num_vertices; ) {
+            auto line_end = next_line(line, end);
+            if (*line != '%') {
+                // NOTE that the internal representation of the graph is 0-based, while the METIS output is 1-based
+                neighbors.clear();
+                auto weight = 1;
+                if (not (has_sizes or has_vertex_weights or has_edge_weights)) {
+                    parse_integers(line, line_end, [&](long value) { neighbors.emplace_back(int(value) - 1); });
+                } else {
+                    // Skip the size, keep the first weight, then take every neighbour (and skip its edge weight)
+                    int position = 0, leading = int(has_sizes) + num_weights;
+                    parse_integers(line, line_end, [&](long value) {
+                        auto index = position++;
+                        if (index < leading) { if (index == int(has_sizes) and has_vertex_weights) weight = int(value); return; }
+                        if (not has_edge_weights or (index - leading) % 2 == 0) neighbors.emplace_back(int(value) - 1);
+                    });
+                }
+                row(c, vertex, neighbors, weight);
+                vertex++;
+            } line = line_end;
+        }
+    });
+}
+
+GraphFormat RawMetisFile::parse_format(const string &name) {
+    if (name == "auto")             return GraphFormat::AUTO;
+    if (name == "metis")            return GraphFormat::METIS;
+    if (name == "edge-list")        return GraphFormat::EDGE_LIST;
+    if (name == "matrix-market")    return GraphFormat::MATRIX_MARKET;
+
+    cout << "[RawMetisFile] Unknown format '" << name << "'; expected one of [ auto, metis, edge-list, matrix-market ]\n";
+    std::exit(-1);
+}
+
+GraphFormat RawMetisFile::detect_format(const string &filepath) {
+    // By extension first, then by the first line: Matrix Market files announce themselves, and SNAP-style edge lists
+    // start with '#' comments; anything else is taken to be METIS
+    if (ends_with(filepath, ".mtx"))                                return GraphFormat::MATRIX_MARKET;
+    if (ends_with(filepath, ".graph") or ends_with(filepath, ".metis"))  return GraphFormat::METIS;
+    for (const auto &extension : { ".txt", ".csv", ".tsv", ".el", ".edges", ".edgelist" }) {
+        if (ends_with(filepath, extension)) return GraphFormat::EDGE_LIST;
+    }
+
+    ifstream ifs(filepath);
+    string line;
+    std::getline(ifs, line);
+    if (line.compare(0, 14, "%%MatrixMarket") == 0)   return GraphFormat::MATRIX_MARKET;
+    if (line.compare(0, 1, "#") == 0)                 return GraphFormat::EDGE_LIST;
+    return GraphFormat::METIS;
+}
 
-        Connections.emplace_back( std::move(row) );
+RawMetisFile RawMetisFile::read(const string &filepath, GraphFormat format, int num_threads) {
+    if (format == GraphFormat::AUTO) format = detect_format(filepath);
+    switch (format) {
+        case GraphFormat::EDGE_LIST:        return read_edge_list(filepath, num_threads);
+        case GraphFormat::MATRIX_MARKET:    return read_matrix_market(filepath, num_threads);
+        default:                            return RawMetisFile(filepath, num_threads);
     }
 }
 
+RawMetisFile RawMetisFile::read_edge_list(const string &filepath, int num_threads) {
+    // One edge per line as two integer ids separated by whitespace or commas (anything after them, e.g. a weight, is
+    // ignored); lines starting with '#' or '%' are comments
+    FileView file(filepath);
+    auto num_chunks = num_chunks_for(file.begin(), file.end(), num_threads);
+    ThreadPool pool(num_threads);
+    auto chunk_starts = split_lines(file.begin(), file.end(), num_chunks);
+
+    vector<vector<pair<long,long>>> raw_edges(num_chunks);
+    vector<vector<long>> chunk_ids(num_chunks);
+    pool.parallel_for(num_chunks, [&](int c, int) {
+        long ids[2];
+        for (auto line = chunk_starts[c]; line < chunk_starts[c + 1]; line = next_line(line, file.end())) {
+            if (*line == '#' or *line == '%') continue;
+            if (parse_first_integers(line, file.end(), ids, 2) == 2) raw_edges[c].emplace_back(ids[0], ids[1]);
+        }
+        for (const auto &edge : raw_edges[c]) { chunk_ids[c].emplace_back(edge.first); chunk_ids[c].emplace_back(edge.second); }
+        std::sort(chunk_ids[c].begin(), chunk_ids[c].end());
+        chunk_ids[c].erase(std::unique(chunk_ids[c].begin(), chunk_ids[c].end()), chunk_ids[c].end());
+    });
+
+    // Vertices are numbered in order of their original ids, so a file using 1..n keeps its numbering; anything else
+    // goes through a hash table, and the original ids are kept in OriginalIds
+    vector<long> ids;
+    for (auto &chunk : chunk_ids) { ids.insert(ids.end(), chunk.begin(), chunk.end()); vector<long>().swap(chunk); }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    auto contiguous = ids.empty() or (ids.back() - ids.front() + 1 == long(ids.size()));
+    unordered_map<long, int> new_ids;
+    if (not contiguous) {
+        new_ids.reserve(ids.size());
+        for (auto i=0U; i < ids.size(); ++i) new_ids.emplace(ids[i], i);
+    }
+    auto first_id = ids.empty() ? 0 : ids.front();
+
+    vector<vector<pair<int,int>>> chunk_edges(num_chunks);
+    pool.parallel_for(num_chunks, [&](int c, int) {
+        for (const auto &edge : raw_edges[c]) {
+            auto u = contiguous ? int(edge.first - first_id) : new_ids.at(edge.first);
+            auto v = contiguous ? int(edge.second - first_id) : new_ids.at(edge.second);
+            if (u != v) chunk_edges[c].emplace_back(u, v);
+        }
+        vector<pair<long,long>>().swap(raw_edges[c]);
+    });
+
+    vector<pair<int,int>> edges;
+    for (auto &chunk : chunk_edges) { edges.insert(edges.end(), chunk.begin(), chunk.end()); vector<pair<int,int>>().swap(chunk); }
+
+    auto graph = from_edges(ids.size(), edges, num_threads);
+    if (not (contiguous and first_id == 1)) graph.OriginalIds = std::move(ids);
+    return graph;
+}
+
+RawMetisFile RawMetisFile::read_matrix_market(const string &filepath, int num_threads) {
+    // Coordinate-format adjacency matrices: a %%MatrixMarket banner, '%' comments, a "rows cols entries" line, then
+    // one 1-based "row col [value]" entry per line.  Values are ignored, diagonal entries dropped, and general
+    // matrices symmetrized.
+    FileView file(filepath);
+    auto p = file.begin(), end = file.end();
+    auto banner = string(p, next_line(p, end));
+    if (banner.compare(0, 14, "%%MatrixMarket") != 0 or banner.find("coordinate") == string::npos) {
+        cout << "[RawMetisFile] '" << filepath << "' is not a coordinate-format Matrix Market file\n";
+        std::exit(-1);
+    }
+    while (p < end and *p == '%') p = next_line(p, end);
+
+    long size[3];
+    auto body = next_line(p, end);
+    if (parse_first_integers(p, body, size, 3) != 3 or size[0] != size[1]) {
+        cout << "[RawMetisFile] Expected a \"rows cols entries\" line for a square matrix in '" << filepath << "'\n";
+        std::exit(-1);
+    }
+    auto num_vertices = int(size[0]);
+
+    auto num_chunks = num_chunks_for(body, end, num_threads);
+    ThreadPool pool(num_threads);
+    auto chunk_starts = split_lines(body, end, num_chunks);
+
+    vector<vector<pair<int,int>>> chunk_edges(num_chunks);
+    pool.parallel_for(num_chunks, [&](int c, int) {
+        long entry[2];
+        for (auto line = chunk_starts[c]; line < chunk_starts[c + 1]; line = next_line(line, end)) {
+            if (*line == '%' or parse_first_integers(line, end, entry, 2) != 2) continue;
+            if (entry[0] < 1 or entry[1] < 1 or entry[0] > num_vertices or entry[1] > num_vertices) {
+                cout << "[RawMetisFile] Matrix entry (" << entry[0] << ", " << entry[1] << ") is out of range in '" << filepath << "'\n";
+                std::exit(-1);
+            }
+            if (entry[0] != entry[1]) chunk_edges[c].emplace_back(int(entry[0]) - 1, int(entry[1]) - 1);
+        }
+    });
+
+    vector<pair<int,int>> edges;
+    for (auto &chunk : chunk_edges) { edges.insert(edges.end(), chunk.begin(), chunk.end()); vector<pair<int,int>>().swap(chunk); }
+    return from_edges(num_vertices, edges, num_threads);
+}
+
+RawMetisFile RawMetisFile::from_edges(int num_vertices, const vector<pair<int,int>> &edges, int num_threads) {
+    // Two passes without any shared writes: each chunk of the edge list scatters both directions of its edges into
+    // one bucket per vertex range, then each vertex range gathers its buckets from every chunk and fills, sorts and
+    // deduplicates its own rows.  Sorting also makes the rows independent of which thread got where first.
+    const int NUM_CHUNKS = 256;
+    auto num_edges = long(edges.size());
+    auto edge_begin = [&](int chunk) { return num_edges * chunk / NUM_CHUNKS; };
+    auto range_begin = [&](int range) { return int((long(range) * num_vertices + NUM_CHUNKS - 1) / NUM_CHUNKS); };
+    auto range_of = [&](int vertex) { return int(long(vertex) * NUM_CHUNKS / num_vertices); };
+
+    ThreadPool pool( (num_threads > 0) ? num_threads : ThreadPool::hardware_threads() );
+    vector<vector<vector<pair<int,int>>>> buckets(NUM_CHUNKS, vector<vector<pair<int,int>>>(NUM_CHUNKS));
+    pool.parallel_for(NUM_CHUNKS, [&](int chunk, int) {
+        auto &chunk_buckets = buckets[chunk];
+        for (auto e=edge_begin(chunk); e < edge_begin(chunk + 1); ++e) {
+            chunk_buckets[range_of(edges[e].first)].emplace_back(edges[e].first, edges[e].second);
+            chunk_buckets[range_of(edges[e].second)].emplace_back(edges[e].second, edges[e].first);
+        }
+    });
+
+    RawMetisFile file;
+    file.Connections.resize(num_vertices);
+    pool.parallel_for(NUM_CHUNKS, [&](int range, int) {
+        auto first = range_begin(range), last = range_begin(range + 1);
+        vector<int> degrees(last - first, 0);
+        for (int chunk=0; chunk < NUM_CHUNKS; ++chunk) for (const auto &edge : buckets[chunk][range]) degrees[edge.first - first]++;
+        for (int v=first; v < last; ++v) file.Connections[v].reserve(degrees[v - first]);
+
+        for (int chunk=0; chunk < NUM_CHUNKS; ++chunk) {
+            for (const auto &edge : buckets[chunk][range]) file.Connections[edge.first].emplace_back(edge.second);
+            vector<pair<int,int>>().swap(buckets[chunk][range]);
+        }
+        for (int v=first; v < last; ++v) {
+            auto &row = file.Connections[v];
+            std::sort(row.begin(), row.end());
+            row.erase(std::unique(row.begin(), row.end()), row.end());
+        }
+    });
+    return file;
+}
+
 int RawMetisFile::num_vertices() {
     return Connections.size();
 }
 
-int RawMetisFile::num_edges() {
-    int count = 0;
+bool RawMetisFile::is_weighted() const {
+    return not VertexWeights.empty();
+}
+
+long RawMetisFile::num_edges() {
+    long count = 0;
     for (const auto &v : Connections) { count += v.size(); }
     return count / 2;
 }
@@ -56,14 +402,52 @@ void RawMetisFile::print() {
     cout << "Number of edges:    " << num_edges() << endl;
 }
 
-void RawMetisFile::write_to_file(const std::string &filepath) {
-    std::ofstream ofs(filepath.c_str(), std::ofstream::out);
-    ofs.sync_with_stdio(false);
-    ofs << num_vertices() << " " << num_edges() << " 0\n";
-    for (const auto &v : Connections) {
-        for (const auto &i : v) {
-            // NOTE that the internal representation of the graph is 0-based, while the METIS output is 1-based
-            ofs << i+1 << " ";
-        } ofs << "\n";
-    } ofs.close();
-}
\ No newline at end of file
+void RawMetisFile::write_to_file(const std::string &filepath, int num_threads) {
+    FILE *out = std::fopen(filepath.c_str(), "wb");
+    if (not out) {
+        cout << "[RawMetisFile] Could not open '" << filepath << "' for writing\n";
+        std::exit(-1);
+    }
+    std::ostringstream header; header << num_vertices() << " " << num_edges() << (is_weighted() ? " 10\n" : " 0\n");
+    std::fwrite(header.str().data(), 1, header.str().size(), out);
+
+    // Rows are formatted in blocks of about BLOCK_ENTRIES adjacency entries, one batch of blocks in parallel at a
+    // time, and each block goes out in a single large write
+    const long BLOCK_ENTRIES = 1 << 20;
+    vector<int> block_starts(1, 0);
+    long entries = 0;
+    for (int v=0; v < num_vertices(); ++v) {
+        entries += Connections[v].size() + 1;
+        if (entries >= BLOCK_ENTRIES) { block_starts.emplace_back(v + 1); entries = 0; }
+    }
+    if (block_starts.back() != num_vertices()) block_starts.emplace_back(num_vertices());
+
+    auto num_blocks = int(block_starts.size()) - 1;
+    ThreadPool pool( std::min((num_threads > 0) ? num_threads : ThreadPool::hardware_threads(), std::max(1, num_blocks)) );
+    auto batch_size = pool.num_threads();
+    vector<string> buffers(batch_size);
+    for (int first_block=0; first_block < num_blocks; first_block += batch_size) {
+        auto blocks_in_batch = std::min(batch_size, num_blocks - first_block);
+        pool.parallel_for(blocks_in_batch, [&](int b, int) {
+            auto block = first_block + b;
+            size_t size = 0;
+            for (int v=block_starts[block]; v < block_starts[block + 1]; ++v) size += (Connections[v].size() + 1) * 11 + 1;
+
+            auto &buffer = buffers[b];
+            buffer.resize(size);
+            auto p = &buffer[0];
+            for (int v=block_starts[block]; v < block_starts[block + 1]; ++v) {
+                if (is_weighted()) { p = format_integer(p, unsigned(VertexWeights[v])); *p++ = ' '; }
+                for (const auto &i : Connections[v]) {
+                    // NOTE that the internal representation of the graph is 0-based, while the METIS output is 1-based
+                    p = format_integer(p, unsigned(i + 1));
+                    *p++ = ' ';
+                } *p++ = '\n';
+            }
+            buffer.resize(p - &buffer[0]);
+        });
+
+        for (int b=0; b < blocks_in_batch; ++b) std::fwrite(buffers[b].data(), 1, buffers[b].size(), out);
+    }
+    std::fclose(out);
+}
@@ -1,18 +1,56 @@
 #ifndef RAW_METIS_FILE_H_
 #define RAW_METIS_FILE_H_
 
+#include <functional>
 #include <vector>
 #include <string>
+#include <utility>
 
+enum class GraphFormat { AUTO, METIS, EDGE_LIST, MATRIX_MARKET };
+
+/*
+    Reading and writing are spread over num_threads threads (0: all cores).  The reader maps the file into memory and
+    parses newline-aligned byte ranges in parallel; the writer formats blocks of rows in parallel into large buffers
+    and writes them out in order.  Lines starting with '%' are METIS comments and are skipped.
+
+    read() also accepts edge lists (SNAP-style, whitespace- or comma-separated, with arbitrary vertex ids) and
+    coordinate Matrix Market files, detected from the extension or the first line.  Their edges are deduplicated and
+    symmetrized into the same adjacency lists; OriginalIds holds the ids an edge list used, unless they were 1..n.
+
+    METIS headers may carry a fmt field ("n m fmt [ncon]"): with vertex weights (fmt 10 or 11) each line starts with
+    ncon weights, of which the first is kept in VertexWeights, and with edge weights (fmt 1 or 11) every neighbour is
+    followed by a weight, which is skipped.  VertexWeights stays empty for unweighted graphs.
+*/
 struct RawMetisFile {
     std::vector<std::vector<int>>   Connections;
+    std::vector<long>               OriginalIds;
+    std::vector<int>                VertexWeights;
 
     RawMetisFile() = default;
-    RawMetisFile(const std::string &filepath);
+    RawMetisFile(const std::string &filepath, int num_threads=0);
     int num_vertices();
-    int num_edges();
+    long num_edges();
+    bool is_weighted() const;
     void print();
-    void write_to_file(const std::string &filepath);
+    void write_to_file(const std::string &filepath, int num_threads=0);
+
+    static RawMetisFile read(const std::string &filepath, GraphFormat format=GraphFormat::AUTO, int num_threads=0);
+    static RawMetisFile read_edge_list(const std::string &filepath, int num_threads=0);
+    static RawMetisFile read_matrix_market(const std::string &filepath, int num_threads=0);
+    static RawMetisFile from_edges(int num_vertices, const std::vector<std::pair<int,int>> &edges, int num_threads=0);
+    static GraphFormat detect_format(const std::string &filepath);
+    static GraphFormat parse_format(const std::string &name);
+
+    /*
+        The METIS parser behind the constructor, for callers that store the rows in a form of their own instead
+        (CompressedGraph).  layout(num_vertices, is_weighted, first_vertex) is called once, with the first vertex of
+        each of the chunks the file is parsed in (num_chunks + 1 entries); then row(chunk, vertex, neighbors, weight)
+        for every vertex, on the chunk's thread and in increasing order within the chunk.  neighbors is the parser's
+        scratch row, which the callback may modify or swap out.
+    */
+    typedef std::function<void(int num_vertices, bool is_weighted, const std::vector<int> &first_vertex)> LayoutCallback;
+    typedef std::function<void(int chunk, int vertex, std::vector<int> &neighbors, int weight)> RowCallback;
+    static void read_metis_rows(const std::string &filepath, int num_threads, const LayoutCallback &layout, const RowCallback &row);
 };
 
 #endif
@@ -0,0 +1,160 @@
+/*
+RejectionFreeKernel.cpp: This module contains the rejection-free (n-fold way) kernel for IMMC.  Instead of drawing random vertices and rejecting most of the proposed flips at low temperature, every call picks a move that is accepted, and only the buckets of the flipped vertex and its neighbours are updated.
+*/
+#include "RejectionFreeKernel.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+void RejectionFreeKernel::init(const EdgeDenotedGraph &graph, const Chromosome &sys, double constant_A, double constant_B) {
+    _graph              = &graph;
+    _constant_A         = constant_A;
+    _constant_B         = constant_B;
+    _beta               = -1;
+    _simulated_steps    = 0;
+    _classes_per_bit    = int(graph.max_vertex_degree) + 1;
+
+    auto num_vertices = graph.num_vertices();
+    _zero_neighbors.assign(num_vertices, 0);
+    _class_of.assign(num_vertices, 0);
+    _position.assign(num_vertices, 0);
+    _buckets.assign(2 * _classes_per_bit, vector<int>());
+    _rates.assign(_buckets.size(), 0);
+    _tree.assign(_buckets.size() + 1, 0);
+
+    // Bucket every vertex by its bit and its number of unmarked neighbours
+    for (int vertex=0; vertex < num_vertices; ++vertex) {
+        auto &z = _zero_neighbors[vertex];
+        graph.for_each_neighbor(vertex, [&](int neighbor_idx) { if (sys.bitfield[neighbor_idx] == 0) z++; });
+
+        auto class_idx = class_index(sys.bitfield[vertex], z);
+        _class_of[vertex] = class_idx;
+        _position[vertex] = _buckets[class_idx].size();
+        _buckets[class_idx].emplace_back(vertex);
+    }
+}
+
+int RejectionFreeKernel::class_index(int bit, int zero_neighbors) const {
+    return ((bit == 0) ? 0 : _classes_per_bit) + zero_neighbors;
+}
+
+double RejectionFreeKernel::hamiltonian_diff(int class_idx) const {
+    // Same Hamiltonian as the Metropolis kernel: +/-A for the vertex added/removed, plus B per newly (un)covered edge
+    auto bit = (class_idx >= _classes_per_bit) ? 1 : 0;
+    auto z = class_idx - ((bit == 0) ? 0 : _classes_per_bit);
+    return _constant_A * ((bit == 0) ? 1.0 : -1.0) + _constant_B * double((bit == 0) ? -z : z);
+}
+
+void RejectionFreeKernel::tree_add(int class_idx, double delta) {
+    for (auto i = class_idx + 1; i < int(_tree.size()); i += i & -i) _tree[i] += delta;
+}
+
+int RejectionFreeKernel::tree_search(double value) const {
+    // Returns the first class whose cumulative weight exceeds value
+    int idx = 0, step = 1;
+    while (step * 2 < int(_tree.size())) step *= 2;
+    for (; step > 0; step /= 2) {
+        if (idx + step < int(_tree.size()) and _tree[idx + step] <= value) {
+            idx += step;
+            value -= _tree[idx];
+        }
+    } return std::min(idx, int(_buckets.size()) - 1);
+}
+
+void RejectionFreeKernel::rebuild_rates(double beta) {
+    _beta = beta;
+    std::fill(_tree.begin(), _tree.end(), 0.0);
+    for (auto c=0U; c < _buckets.size(); ++c) {
+        _rates[c] = std::min(1.0, std::exp(-beta * hamiltonian_diff(c)));
+        _tree[c+1] += _rates[c] * _buckets[c].size();
+        auto parent = (c+1) + ((c+1) & -(c+1));
+        if (parent < _tree.size()) _tree[parent] += _tree[c+1];
+    }
+}
+
+void RejectionFreeKernel::move_vertex(int vertex, int new_class) {
+    auto old_class = _class_of[vertex];
+    if (old_class == new_class) return;
+
+    // Swap-remove from the old bucket
+    auto &old_bucket = _buckets[old_class];
+    auto last = old_bucket.back();
+    old_bucket[_position[vertex]] = last;
+    _position[last] = _position[vertex];
+    old_bucket.pop_back();
+    tree_add(old_class, -_rates[old_class]);
+
+    _class_of[vertex] = new_class;
+    _position[vertex] = _buckets[new_class].size();
+    _buckets[new_class].emplace_back(vertex);
+    tree_add(new_class, _rates[new_class]);
+}
+
+int RejectionFreeKernel::select(Random &ran3, double beta, double &proposals) {
+    if (beta != _beta) rebuild_rates(beta);
+
+    // Total rate of leaving the current state; Fenwick sums drift slightly under repeated updates, so rebuild if needed
+    auto total = 0.0;
+    for (auto i = int(_tree.size()) - 1; i > 0; i -= i & -i) total += _tree[i];
+    if (total <= 0) { rebuild_rates(beta); total = 0; for (auto i = int(_tree.size()) - 1; i > 0; i -= i & -i) total += _tree[i]; }
+
+    auto class_idx = tree_search(ran3() * total);
+    while (_buckets[class_idx].empty()) class_idx = (class_idx + 1) % _buckets.size();
+    auto &bucket = _buckets[class_idx];
+    auto vertex = bucket[ std::min(int(ran3(bucket.size())), int(bucket.size()) - 1) ];
+
+    /*
+        A plain Metropolis step accepts with probability p = total / |V|, so the accepted move stands in for a
+        geometrically distributed number of proposals; advance the simulated clock by that many steps.
+    */
+    auto p = total / _graph->num_vertices();
+    proposals = (p >= 1.0) ? 1.0 : 1.0 + std::floor(std::log(1.0 - ran3()) / std::log1p(-p));
+    _simulated_steps += proposals;
+
+    return vertex;
+}
+
+int RejectionFreeKernel::marginal_edge_cost(int vertex) const {
+    auto z = _zero_neighbors[vertex];
+    return (_class_of[vertex] < _classes_per_bit) ? -z : z;
+}
+
+void RejectionFreeKernel::apply_flip(int vertex, int new_bit) {
+    move_vertex(vertex, class_index(new_bit, _zero_neighbors[vertex]));
+
+    // Only the flipped vertex's neighbours change class: each gains or loses one unmarked neighbour
+    auto delta = (new_bit == 0) ? 1 : -1;
+    _graph->for_each_neighbor(vertex, [&](int neighbor_idx) {
+        _zero_neighbors[neighbor_idx] += delta;
+        auto neighbor_bit = (_class_of[neighbor_idx] >= _classes_per_bit) ? 1 : 0;
+        move_vertex(neighbor_idx, class_index(neighbor_bit, _zero_neighbors[neighbor_idx]));
+    });
+}
+
+double RejectionFreeKernel::simulated_steps() const {
+    return _simulated_steps;
+}
+
+void RejectionFreeKernel::save(CheckpointWriter &checkpoint) const {
+    // The bucket order and the Fenwick sums depend on the flips so far, not just the current state, so a resumed run
+    // only draws the same moves if they are restored as they were
+    checkpoint.put(_beta); checkpoint.put(_simulated_steps);
+    checkpoint.put_vector(_rates); checkpoint.put_vector(_tree);
+    checkpoint.put(uint64_t(_buckets.size()));
+    for (const auto &bucket : _buckets) checkpoint.put_vector(bucket);
+}
+
+void RejectionFreeKernel::load(CheckpointReader &checkpoint) {
+    // After init on the same graph and system, which sets up everything else
+    _beta = checkpoint.get<double>(); _simulated_steps = checkpoint.get<double>();
+    _rates = checkpoint.get_vector<double>(); _tree = checkpoint.get_vector<double>();
+    checkpoint.check(checkpoint.get<uint64_t>() == _buckets.size() and _rates.size() == _buckets.size() and _tree.size() == _buckets.size() + 1,
+                     "has rejection-free kernel buckets for a different graph");
+    for (auto c=0U; c < _buckets.size(); ++c) {
+        auto bucket = checkpoint.get_vector<int>();
+        checkpoint.check(bucket.size() == _buckets[c].size(), "has rejection-free kernel buckets for a different system");
+        for (auto i=0U; i < bucket.size(); ++i) _position[ bucket[i] ] = i;
+        _buckets[c] = std::move(bucket);
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef REJECTION_FREE_KERNEL_H_
+#define REJECTION_FREE_KERNEL_H_
+
+#include "EdgeDenotedGraph.h"
+#include "Chromosome.h"
+#include "Random.h"
+#include "Checkpoint.h"
+#include <vector>
+
+/*
+    n-fold way (Bortz-Kalos-Lebowitz) kernel for the Ising MC algorithm.  The energy change of flipping vertex v only
+    depends on its bit x_v and the number z_v of its neighbours whose bit is 0, so vertices are bucketed by the class
+    (x_v, z_v).  Every class has a Metropolis acceptance rate min(1, exp(-beta*dE)); the next *accepted* move is drawn
+    directly with probability proportional to the rates, and the simulated clock is advanced by the number of plain
+    Metropolis proposals that the move stands in for.
+*/
+class RejectionFreeKernel {
+    const EdgeDenotedGraph      *_graph = nullptr;
+    double                      _constant_A         = 1;
+    double                      _constant_B         = 100;
+    double                      _beta               = -1;
+    double                      _simulated_steps    = 0;
+    int                         _classes_per_bit    = 0;
+
+    std::vector<int>                _zero_neighbors;    // z_v for each vertex
+    std::vector<int>                _class_of;          // class index of each vertex
+    std::vector<int>                _position;          // index of each vertex within its class bucket
+    std::vector<std::vector<int>>   _buckets;           // vertices in each class
+    std::vector<double>             _rates;             // acceptance rate of each class
+    std::vector<double>             _tree;              // Fenwick tree over (bucket size * rate) of each class
+
+    int class_index(int bit, int zero_neighbors) const;
+    double hamiltonian_diff(int class_idx) const;
+    void tree_add(int class_idx, double delta);
+    int tree_search(double value) const;
+    void rebuild_rates(double beta);
+    void move_vertex(int vertex, int new_class);
+
+  public:
+    RejectionFreeKernel() = default;
+    void init(const EdgeDenotedGraph &graph, const Chromosome &sys, double constant_A, double constant_B);
+    int select(Random &ran3, double beta, double &proposals);
+    int marginal_edge_cost(int vertex) const;
+    void apply_flip(int vertex, int new_bit);
+    double simulated_steps() const;
+    void save(CheckpointWriter &checkpoint) const;
+    void load(CheckpointReader &checkpoint);
+};
+
+#endif
@@ -0,0 +1,139 @@
+/*
+RunTimeDistribution.cpp: QRTD/SQD, convergence and time-to-target statistics computed from the traces of many runs, replacing the offline analysis.py pass
+*/
+#include "RunTimeDistribution.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace {
+    // Evenly spaced points in [start, end), like np.arange(start, end, (end-start)/n); a single point if the range is empty
+    vector<double> increments(double start, double end, int n) {
+        if (not (end > start)) return { start };
+        vector<double> points(n);
+        for (int i=0; i < n; ++i) points[i] = start + i * (end - start) / n;
+        return points;
+    }
+}
+
+RunTimeDistribution::RunTimeDistribution(int optimum) : _optimum(optimum) {}
+
+void RunTimeDistribution::add_run(const vector<TracePoint> &trace) {
+    // A run that never found a cover tells us nothing about run-times
+    if (not trace.empty()) runs.emplace_back(trace);
+}
+
+int RunTimeDistribution::num_runs() const {
+    return runs.size();
+}
+
+double RunTimeDistribution::relative_error(int cover_size) const {
+    return double(cover_size - _optimum) / _optimum;
+}
+
+int RunTimeDistribution::cover_size_at(const vector<TracePoint> &trace, double time_sec) const {
+    // Traces are ordered by time, so the cover held at time_sec is the last one found at or before it
+    auto it = std::upper_bound(trace.begin(), trace.end(), time_sec, [](double t, const TracePoint &point) { return t < point.time_sec; });
+    return (it == trace.begin()) ? std::numeric_limits<int>::max() : std::prev(it)->cover_size;
+}
+
+double RunTimeDistribution::solved_fraction(double time_sec, double rel_error) const {
+    int solved = 0;
+    for (const auto &trace : runs) {
+        auto cover_size = cover_size_at(trace, time_sec);
+        if (cover_size != std::numeric_limits<int>::max() and relative_error(cover_size) <= rel_error) solved++;
+    } return runs.empty() ? 0 : double(solved) / runs.size();
+}
+
+double RunTimeDistribution::time_to_target(const vector<TracePoint> &trace, double rel_error) const {
+    for (const auto &point : trace) if (relative_error(point.cover_size) <= rel_error) return point.time_sec;
+    return std::numeric_limits<double>::infinity();
+}
+
+double RunTimeDistribution::min_relative_error() const {
+    int worst = 0;
+    for (const auto &trace : runs) worst = std::max(worst, trace.back().cover_size);
+    return relative_error(worst);
+}
+
+double RunTimeDistribution::max_relative_error() const {
+    int worst = 0;
+    for (const auto &trace : runs) worst = std::max(worst, trace.front().cover_size);
+    return relative_error(worst);
+}
+
+double RunTimeDistribution::start_time() const {
+    double latest = 0;
+    for (const auto &trace : runs) latest = std::max(latest, trace.front().time_sec);
+    return latest;
+}
+
+double RunTimeDistribution::end_time() const {
+    double latest = 0;
+    for (const auto &trace : runs) latest = std::max(latest, trace.back().time_sec);
+    return latest;
+}
+
+void RunTimeDistribution::write_qrtd_csv(ostream &os, int num_curves, int num_points) const {
+    // One column per relative error, giving the fraction of runs within that error at each time
+    auto rel_errors = increments(min_relative_error(), max_relative_error(), num_curves);
+    for (auto rel_error : rel_errors) os << "," << rel_error;
+    os << "\n";
+    for (auto time_sec : increments(start_time(), end_time(), num_points)) {
+        os << time_sec;
+        for (auto rel_error : rel_errors) os << "," << solved_fraction(time_sec, rel_error);
+        os << "\n";
+    }
+}
+
+void RunTimeDistribution::write_sqd_csv(ostream &os, int num_curves, int num_points) const {
+    // One column per time, giving the fraction of runs within each relative error by then
+    auto times = increments(start_time(), end_time(), num_curves);
+    for (auto time_sec : times) os << "," << time_sec;
+    os << "\n";
+    for (auto rel_error : increments(min_relative_error(), max_relative_error(), num_points)) {
+        os << rel_error;
+        for (auto time_sec : times) os << "," << solved_fraction(time_sec, rel_error);
+        os << "\n";
+    }
+}
+
+void RunTimeDistribution::write_convergence_csv(ostream &os, int num_points) const {
+    // Runs that have not found a cover yet count with their first one
+    os << ",average vc size\n";
+    for (auto time_sec : increments(start_time(), end_time(), num_points)) {
+        double total = 0;
+        for (const auto &trace : runs) {
+            auto cover_size = cover_size_at(trace, time_sec);
+            total += relative_error( (cover_size == std::numeric_limits<int>::max()) ? trace.front().cover_size : cover_size );
+        }
+        os << time_sec << "," << (runs.empty() ? 0 : total / runs.size()) << "\n";
+    }
+}
+
+void RunTimeDistribution::write_time_to_target_csv(ostream &os, const vector<double> &relative_errors, const vector<double> &percentiles) const {
+    // Nearest-rank percentiles over all runs; runs that never reached the target count as infinitely slow and
+    // leave the cell empty once the percentile falls on them
+    os << "relative_error,solved_fraction";
+    for (auto percentile : percentiles) os << ",p" << percentile;
+    os << "\n";
+
+    for (auto rel_error : relative_errors) {
+        vector<double> times;
+        for (const auto &trace : runs) times.emplace_back(time_to_target(trace, rel_error));
+        std::sort(times.begin(), times.end());
+        auto num_solved = std::count_if(times.begin(), times.end(), [](double t) { return std::isfinite(t); });
+
+        os << rel_error << "," << (times.empty() ? 0 : double(num_solved) / times.size());
+        for (auto percentile : percentiles) {
+            os << ",";
+            if (times.empty()) continue;
+            auto rank = std::max(1, int(std::ceil(percentile / 100.0 * times.size())));
+            auto time_sec = times[std::min(rank, int(times.size())) - 1];
+            if (std::isfinite(time_sec)) os << time_sec;
+        }
+        os << "\n";
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef CSE6140_RUN_TIME_DISTRIBUTION_
+#define CSE6140_RUN_TIME_DISTRIBUTION_
+
+#include "Utilities.h"
+#include <ostream>
+#include <vector>
+
+/*
+    Empirical run-time statistics over many runs of one method on one graph, computed from their traces against a
+    known optimal cover size: qualified run-time distributions (QRTD), solution-quality distributions (SQD), the
+    convergence of the average relative error, and percentiles of the time needed to reach a target quality.
+    The CSVs have the same layout as the ones analysis.py writes.
+*/
+class RunTimeDistribution {
+    int                                     _optimum;
+    std::vector<std::vector<TracePoint>>    runs;
+
+    // Plotting ranges, as in analysis.py: from the worst final to the worst initial relative error, and from the
+    // latest first improvement to the latest last one
+    double  min_relative_error() const;
+    double  max_relative_error() const;
+    double  start_time() const;
+    double  end_time() const;
+
+    double  relative_error(int cover_size) const;
+    int     cover_size_at(const std::vector<TracePoint> &trace, double time_sec) const;
+    double  solved_fraction(double time_sec, double relative_error) const;
+    double  time_to_target(const std::vector<TracePoint> &trace, double relative_error) const;
+
+  public:
+    RunTimeDistribution(int optimum);
+    void add_run(const std::vector<TracePoint> &trace);
+    int num_runs() const;
+
+    void write_qrtd_csv(std::ostream &os, int num_curves=7, int num_points=100) const;
+    void write_sqd_csv(std::ostream &os, int num_curves=7, int num_points=100) const;
+    void write_convergence_csv(std::ostream &os, int num_points=100) const;
+    void write_time_to_target_csv(std::ostream &os, const std::vector<double> &relative_errors, const std::vector<double> &percentiles) const;
+};
+
+#endif
@@ -0,0 +1,110 @@
+/*
+SolutionPool.cpp: This module keeps a bounded, duplicate-free archive of the best vertex covers found, keyed by Zobrist hashes of their bitfields
+*/
+#include "SolutionPool.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+SolutionPool::SolutionPool(int capacity) : _capacity(std::max(1, capacity)) {}
+
+vector<uint64_t> SolutionPool::pack(const vector<int> &bitfield) {
+    vector<uint64_t> bits((bitfield.size() + 63) / 64, 0);
+    for (auto i=0U; i < bitfield.size(); ++i) if (bitfield[i] != 0) bits[i / 64] |= uint64_t(1) << (i % 64);
+    return bits;
+}
+
+Chromosome SolutionPool::unpack(int position, int num_bits, int max_vertex_weight) const {
+    auto bitfield = vector<int>(num_bits, 0);
+    for (int i=0; i < num_bits; ++i) bitfield[i] = (_entries[position].bits[i / 64] >> (i % 64)) & 1;
+    Chromosome cover(bitfield);
+    cover.filled_bits = _entries[position].size;
+    cover.cover_weight = _entries[position].cost;
+    cover.is_vc = true;
+    cover.update_score(max_vertex_weight);
+    return cover;
+}
+
+bool SolutionPool::accepts(int cover_cost) const {
+    // Whether a (new) cover of this cost would be kept; lets callers skip packing covers that would be turned away
+    lock_guard<mutex> lock(_mutex);
+    return int(_entries.size()) < _capacity or cover_cost < _entries[_worst].cost;
+}
+
+bool SolutionPool::insert(const Chromosome &cover) {
+    // Only vertex covers are kept; returns whether the cover was added
+    if (not cover.is_vc) return false;
+    lock_guard<mutex> lock(_mutex);
+    if (_positions.count(cover.hash)) { _num_duplicates++; return false; }
+
+    int position = _entries.size();
+    if (int(_entries.size()) == _capacity) {
+        auto worst_cost = _entries[_worst].cost;
+        if (cover.cover_weight >= worst_cost) return false;
+
+        // Among the most costly covers, replace the one closest to the new one
+        auto bits = pack(cover.bitfield);
+        auto min_distance = std::numeric_limits<int>::max();
+        for (auto i=0U; i < _entries.size(); ++i) {
+            if (_entries[i].cost != worst_cost) continue;
+            auto distance = 0;
+            for (auto w=0U; w < bits.size(); ++w) distance += __builtin_popcountll(bits[w] ^ _entries[i].bits[w]);
+            if (distance < min_distance) { min_distance = distance; position = i; }
+        }
+        _positions.erase(_entries[position].hash);
+        _entries[position] = Entry { cover.hash, cover.cover_weight, cover.filled_bits, std::move(bits) };
+    } else _entries.emplace_back( Entry { cover.hash, cover.cover_weight, cover.filled_bits, pack(cover.bitfield) } );
+    _positions.emplace(cover.hash, position);
+
+    _best = _worst = 0;
+    for (auto i=1U; i < _entries.size(); ++i) {
+        if (_entries[i].cost < _entries[_best].cost) _best = i;
+        if (_entries[i].cost > _entries[_worst].cost) _worst = i;
+    } return true;
+}
+
+bool SolutionPool::contains(uint64_t hash) const {
+    // Whether a cover of this hash is already held, so callers can skip work on covers that were found before
+    lock_guard<mutex> lock(_mutex);
+    return _positions.count(hash) > 0;
+}
+
+int SolutionPool::size() const {
+    lock_guard<mutex> lock(_mutex);
+    return _entries.size();
+}
+
+int SolutionPool::capacity() const {
+    return _capacity;
+}
+
+int SolutionPool::best_cost() const {
+    lock_guard<mutex> lock(_mutex);
+    return (_best < 0) ? std::numeric_limits<int>::max() : _entries[_best].cost;
+}
+
+long SolutionPool::num_duplicates() const {
+    lock_guard<mutex> lock(_mutex);
+    return _num_duplicates;
+}
+
+void SolutionPool::save(CheckpointWriter &checkpoint) const {
+    lock_guard<mutex> lock(_mutex);
+    checkpoint.put(_capacity); checkpoint.put(_num_duplicates);
+    checkpoint.put(uint64_t(_entries.size()));
+    for (const auto &entry : _entries) { checkpoint.put(entry.hash); checkpoint.put(entry.cost); checkpoint.put(entry.size); checkpoint.put_vector(entry.bits); }
+}
+
+void SolutionPool::load(CheckpointReader &checkpoint) {
+    lock_guard<mutex> lock(_mutex);
+    _capacity = checkpoint.get<int>(); _num_duplicates = checkpoint.get<long>();
+    _entries.resize( checkpoint.get<uint64_t>() );
+    _positions.clear(); _best = _worst = -1;
+    for (auto i=0U; i < _entries.size(); ++i) {
+        _entries[i].hash = checkpoint.get<uint64_t>(); _entries[i].cost = checkpoint.get<int>(); _entries[i].size = checkpoint.get<int>(); _entries[i].bits = checkpoint.get_vector<uint64_t>();
+        _positions.emplace(_entries[i].hash, i);
+        if (_best < 0 or _entries[i].cost < _entries[_best].cost) _best = i;
+        if (_worst < 0 or _entries[i].cost > _entries[_worst].cost) _worst = i;
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef CSE6140_SOLUTION_POOL_
+#define CSE6140_SOLUTION_POOL_
+
+#include "Chromosome.h"
+#include "Checkpoint.h"
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/*
+    Bounded archive of distinct vertex covers, shared by GA and IMMC.  Covers are keyed by their Chromosome::hash (a
+    Zobrist hash kept up to date by every bit flip), so a cover already in the pool is turned away in O(1), without
+    looking at its bits.  Two different covers of the same hash would be taken for one; with 64-bit keys and a pool of
+    a few dozen covers, the odds of that are around 2^-58 per insertion.  Entries are stored as packed bitsets, n/8
+    bytes each instead of a full Chromosome.
+
+    Covers are ranked by cost, their Chromosome::cover_weight (their size, on an unweighted graph).  Once the pool is
+    full, a cover only gets in if it is cheaper than the most costly one held.  It then replaces, among those, the one
+    closest to it in Hamming distance, so the pool keeps covers from different regions of the search space rather than
+    many near-copies of one.  All methods lock, so solvers in different threads can share a pool, as long as they run
+    on the same graph with the same vertex numbering.
+*/
+class SolutionPool {
+    struct Entry {
+        std::uint64_t               hash;
+        int                         cost;
+        int                         size;
+        std::vector<std::uint64_t>  bits;
+    };
+
+    std::vector<Entry>                      _entries;
+    std::unordered_map<std::uint64_t, int>  _positions;     // hash -> position in _entries
+    int                                     _capacity;
+    int                                     _best           = -1;
+    int                                     _worst          = -1;
+    long                                    _num_duplicates = 0;
+    mutable std::mutex                      _mutex;
+
+    static std::vector<std::uint64_t> pack(const std::vector<int> &bitfield);
+    Chromosome unpack(int position, int num_bits, int max_vertex_weight) const;
+
+  public:
+    explicit SolutionPool(int capacity=16);
+    bool accepts(int cover_cost) const;
+    bool insert(const Chromosome &cover);
+    bool contains(std::uint64_t hash) const;
+
+    int size() const;
+    int capacity() const;
+    int best_cost() const;
+    template <typename Graph> Chromosome best(const Graph &graph) const;
+    long num_duplicates() const;
+    void save(CheckpointWriter &checkpoint) const;
+    void load(CheckpointReader &checkpoint);
+};
+
+// The cheapest cover in the pool, or the full cover of the graph (an EdgeDenotedGraph or CompressedGraph) if it is empty
+template <typename Graph>
+Chromosome SolutionPool::best(const Graph &graph) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (_best < 0) ? Chromosome::full_cover(graph) : unpack(_best, graph.num_vertices(), graph.max_vertex_weight());
+}
+
+#endif
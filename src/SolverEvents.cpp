@@ -0,0 +1,77 @@
+/*
+SolverEvents.cpp: This module contains the cancellation token checked by the solvers, and streams their improvements as newline-delimited JSON to stdout or a Unix domain socket
+*/
+#include "SolverEvents.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+ImprovementStream::ImprovementStream(const string &target) {
+    // "stdout", or "unix:<path>" to connect to a socket a listener has bound at <path>
+    if (target == "stdout") { _fd = STDOUT_FILENO; return; }
+
+    const string prefix = "unix:";
+    if (target.compare(0, prefix.size(), prefix) != 0) {
+        cout << "[SolverEvents] Unknown stream target '" << target << "'; expected stdout or unix:<path>" << endl;
+        std::exit(-1);
+    }
+    auto path = target.substr(prefix.size());
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() or path.size() >= sizeof(address.sun_path)) {
+        cout << "[SolverEvents] Invalid socket path '" << path << "'" << endl;
+        std::exit(-1);
+    }
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    _fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_fd < 0 or ::connect(_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        cout << "[SolverEvents] Cannot connect to socket '" << path << "': " << std::strerror(errno) << endl;
+        std::exit(-1);
+    }
+    _owns_fd = true;
+}
+
+ImprovementStream::~ImprovementStream() {
+    if (_owns_fd) ::close(_fd);
+}
+
+void ImprovementStream::write_line(const string &line) {
+    // A listener that went away does not stop the solve; its events are dropped
+    lock_guard<mutex> lock(_mutex);
+    if (_fd < 0) return;
+    if (_fd == STDOUT_FILENO) cout.flush();
+    for (size_t written = 0; written < line.size(); ) {
+        auto n = ::send(_fd, line.data() + written, line.size() - written, MSG_NOSIGNAL);
+        if (n < 0 and errno == ENOTSOCK) n = ::write(_fd, line.data() + written, line.size() - written);
+        if (n < 0 and errno == EINTR) continue;
+        if (n <= 0) { if (_owns_fd) ::close(_fd); _fd = -1; _owns_fd = false; return; }
+        written += n;
+    }
+}
+
+void ImprovementStream::write_improvement(const Improvement &improvement) {
+    ostringstream oss;
+    oss << "{\"event\":\"improvement\",\"solver\":\"" << improvement.solver << "\",\"time_sec\":" << improvement.time_sec
+        << ",\"cover_size\":" << improvement.cover_size << "}\n";
+    write_line(oss.str());
+}
+
+void ImprovementStream::write_finished(const Improvement &final_cover, bool cancelled) {
+    ostringstream oss;
+    oss << "{\"event\":\"finished\",\"solver\":\"" << final_cover.solver << "\",\"time_sec\":" << final_cover.time_sec
+        << ",\"cover_size\":" << final_cover.cover_size << ",\"cancelled\":" << (cancelled ? "true" : "false") << "}\n";
+    write_line(oss.str());
+}
+
+ImprovementCallback ImprovementStream::callback() {
+    return [this](const Improvement &improvement) { write_improvement(improvement); };
+}
@@ -0,0 +1,63 @@
+#ifndef CSE6140_SOLVER_EVENTS_
+#define CSE6140_SOLVER_EVENTS_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/*
+    Cooperative cancellation: a solver given a token checks it wherever it checks its time budget, and stops the
+    same way it stops at the cutoff (writing its best cover so far).  cancel() only sets a lock-free flag, so it may be
+    called from another thread, from an improvement callback, or from a signal handler.
+*/
+class CancellationToken {
+    std::atomic<bool> _cancelled { false };
+
+  public:
+    void cancel() { _cancelled.store(true, std::memory_order_relaxed); }
+    bool cancelled() const { return _cancelled.load(std::memory_order_relaxed); }
+};
+
+typedef std::shared_ptr<CancellationToken> CancellationHandle;
+
+inline bool is_cancelled(const CancellationHandle &token) { return token and token->cancelled(); }
+
+// A new best cover: its size in the input graph and the time since the run started, as written to the trace file
+struct Improvement {
+    std::string     solver;
+    double          time_sec;
+    int             cover_size;
+};
+
+// Called on the solver's thread for every improvement, right after it is written to the trace file; keep it short
+typedef std::function<void(const Improvement&)> ImprovementCallback;
+
+/*
+    Streams improvements as newline-delimited JSON, one object per line, to stdout or to a Unix domain socket that
+    another process listens on:
+        {"event":"improvement","solver":"GA","time_sec":0.52,"cover_size":2215}
+        {"event":"finished","solver":"GA","time_sec":10,"cover_size":2203,"cancelled":false}
+    On stdout the lines are interleaved with the solvers' log lines, which never start with '{'.  Each line is
+    written whole under a lock, so solvers on several threads may share a stream.
+*/
+class ImprovementStream {
+    int             _fd         = -1;
+    bool            _owns_fd    = false;
+    std::mutex      _mutex;
+
+    void write_line(const std::string &line);
+
+  public:
+    explicit ImprovementStream(const std::string &target);
+    ~ImprovementStream();
+    ImprovementStream(const ImprovementStream&) = delete;
+    ImprovementStream& operator=(const ImprovementStream&) = delete;
+
+    void write_improvement(const Improvement &improvement);
+    void write_finished(const Improvement &final_cover, bool cancelled);
+    ImprovementCallback callback();
+};
+
+#endif
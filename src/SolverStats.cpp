@@ -0,0 +1,64 @@
+/*
+SolverStats.cpp: counters and phase timers describing what a solver did during a run, written out as JSON so runs can be compared between commits
+*/
+#include "SolverStats.h"
+
+using namespace std;
+
+const char* counter_name(Counter counter) {
+    switch (counter) {
+        case Counter::MOVES_PROPOSED:                   return "moves_proposed";
+        case Counter::MOVES_ACCEPTED:                   return "moves_accepted";
+        case Counter::FITNESS_EVALUATIONS:              return "fitness_evaluations";
+        case Counter::CROSSOVERS:                       return "crossovers";
+        case Counter::MUTATIONS:                        return "mutations";
+        case Counter::LOCAL_SEARCH_IMPROVEMENTS:        return "local_search_improvements";
+        case Counter::SOLUTIONS_FOUND:                  return "solutions_found";
+        case Counter::DUPLICATES_REJECTED:              return "duplicates_rejected";
+        case Counter::NODES_EXPANDED:                   return "nodes_expanded";
+        case Counter::NODES_PRUNED_BY_BEST:             return "nodes_pruned_by_best";
+        case Counter::NODES_PRUNED_BY_APPROXIMATION:    return "nodes_pruned_by_approximation";
+        case Counter::NODES_PRUNED_BY_LP_BOUND:         return "nodes_pruned_by_lp_bound";
+        case Counter::NODES_PRUNED_BY_CLIQUE_BOUND:     return "nodes_pruned_by_clique_bound";
+        case Counter::NODES_BACKTRACKED:                return "nodes_backtracked";
+        case Counter::EDGES_REMOVED:                    return "edges_removed";
+        case Counter::EDGES_RESTORED:                   return "edges_restored";
+        case Counter::ALLOCATIONS:                      return "allocations";
+        case Counter::NUM_COUNTERS:                     break;
+    } return "unknown";
+}
+
+const char* phase_name(Phase phase) {
+    switch (phase) {
+        case Phase::INITIALIZATION:     return "initialization";
+        case Phase::SEARCH:             return "search";
+        case Phase::FITNESS:            return "fitness";
+        case Phase::REPRODUCTION:       return "reproduction";
+        case Phase::MUTATION:           return "mutation";
+        case Phase::LOCAL_SEARCH:       return "local_search";
+        case Phase::KERNEL:             return "kernel";
+        case Phase::BOUND:              return "bound";
+        case Phase::BRANCH:             return "branch";
+        case Phase::OUTPUT:             return "output";
+        case Phase::NUM_PHASES:         break;
+    } return "unknown";
+}
+
+void BasicSolverStats<true>::write_json(ostream &os) const {
+    os << "{\n  \"solver\": \"" << _solver << "\",\n  \"enabled\": true,\n  \"counters\": {";
+    for (size_t i=0; i < counters.size(); ++i) {
+        os << ((i == 0) ? "\n" : ",\n") << "    \"" << counter_name(Counter(i)) << "\": " << counters[i];
+    }
+    os << "\n  },\n  \"phases_ms\": {";
+    for (size_t i=0; i < phase_ms.size(); ++i) {
+        os << ((i == 0) ? "\n" : ",\n") << "    \"" << phase_name(Phase(i)) << "\": " << phase_ms[i];
+    }
+    os << "\n  },\n  \"phase_cycles\": {";
+    for (size_t i=0; i < phase_cycles.size(); ++i) {
+        os << ((i == 0) ? "\n" : ",\n") << "    \"" << phase_name(Phase(i)) << "\": " << phase_cycles[i];
+    } os << "\n  }\n}\n";
+}
+
+void BasicSolverStats<false>::write_json(ostream &os) const {
+    os << "{\n  \"enabled\": false\n}\n";
+}
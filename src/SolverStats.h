@@ -0,0 +1,104 @@
+#ifndef CSE6140_SOLVER_STATS_
+#define CSE6140_SOLVER_STATS_
+
+#include "Stopwatch.h"
+#include <array>
+#include <chrono>
+#include <ostream>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*
+    Instrumentation is compiled out of release builds (NDEBUG) unless CSE6140_SOLVER_STATS is set explicitly,
+    e.g. with -DCSE6140_SOLVER_STATS=1 in CMAKE_CXX_FLAGS.
+*/
+#ifndef CSE6140_SOLVER_STATS
+#  ifdef NDEBUG
+#    define CSE6140_SOLVER_STATS 0
+#  else
+#    define CSE6140_SOLVER_STATS 1
+#  endif
+#endif
+
+enum class Counter {
+    MOVES_PROPOSED, MOVES_ACCEPTED, FITNESS_EVALUATIONS, CROSSOVERS, MUTATIONS, LOCAL_SEARCH_IMPROVEMENTS, SOLUTIONS_FOUND,
+    DUPLICATES_REJECTED,
+    NODES_EXPANDED, NODES_PRUNED_BY_BEST, NODES_PRUNED_BY_APPROXIMATION, NODES_PRUNED_BY_LP_BOUND, NODES_PRUNED_BY_CLIQUE_BOUND,
+    NODES_BACKTRACKED,
+    EDGES_REMOVED, EDGES_RESTORED, ALLOCATIONS,
+    NUM_COUNTERS
+};
+
+enum class Phase {
+    INITIALIZATION, SEARCH, FITNESS, REPRODUCTION, MUTATION, LOCAL_SEARCH, KERNEL, BOUND, BRANCH, OUTPUT,
+    NUM_PHASES
+};
+
+const char* counter_name(Counter counter);
+const char* phase_name(Phase phase);
+
+// Cycle counter for very short sections; falls back to the steady clock (in ns) off x86
+inline unsigned long long read_cycle_counter() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+template <bool Enabled> class BasicSolverStats;
+
+template <>
+class BasicSolverStats<true> {
+    std::string _solver;
+    std::array<long long, size_t(Counter::NUM_COUNTERS)>        counters {};
+    std::array<double, size_t(Phase::NUM_PHASES)>               phase_ms {};
+    std::array<unsigned long long, size_t(Phase::NUM_PHASES)>   phase_cycles {};
+
+  public:
+    static constexpr bool enabled = true;
+
+    BasicSolverStats(const std::string &solver = "") : _solver(solver) {}
+    void count(Counter counter, long long n=1) { counters[size_t(counter)] += n; }
+    long long get(Counter counter) const { return counters[size_t(counter)]; }
+    double elapsed_ms(Phase phase) const { return phase_ms[size_t(phase)]; }
+    void write_json(std::ostream &os) const;
+
+    // Wall-clock timer (Stopwatch) for a phase, added to the phase's total when it goes out of scope
+    class ScopedPhase {
+        BasicSolverStats &_stats; Phase _phase; Stopwatch _stopwatch;
+      public:
+        ScopedPhase(BasicSolverStats &stats, Phase phase) : _stats(stats), _phase(phase) {}
+        ~ScopedPhase() { _stats.phase_ms[size_t(_phase)] += _stopwatch.elapsed_ms(); }
+    };
+
+    // rdtsc-based timer for sections too short for the Stopwatch
+    class ScopedCycles {
+        BasicSolverStats &_stats; Phase _phase; unsigned long long _start;
+      public:
+        ScopedCycles(BasicSolverStats &stats, Phase phase) : _stats(stats), _phase(phase), _start(read_cycle_counter()) {}
+        ~ScopedCycles() { _stats.phase_cycles[size_t(_phase)] += read_cycle_counter() - _start; }
+    };
+};
+
+template <>
+class BasicSolverStats<false> {
+  public:
+    static constexpr bool enabled = false;
+
+    BasicSolverStats(const std::string & = "") {}
+    void count(Counter, long long=1) {}
+    long long get(Counter) const { return 0; }
+    double elapsed_ms(Phase) const { return 0; }
+    void write_json(std::ostream &os) const;
+
+    struct ScopedPhase { ScopedPhase(BasicSolverStats &, Phase) {} };
+    struct ScopedCycles { ScopedCycles(BasicSolverStats &, Phase) {} };
+};
+
+typedef BasicSolverStats<CSE6140_SOLVER_STATS != 0> SolverStats;
+
+#endif
@@ -9,6 +9,11 @@ void Stopwatch::reset() {
 	start = chrono::steady_clock::now();
 }
 
+void Stopwatch::reset(double elapsed_ms) {
+	// Restart as if elapsed_ms had already gone by, e.g. to continue a resumed run
+	start = chrono::steady_clock::now() - chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double, milli>(elapsed_ms));
+}
+
 double Stopwatch::elapsed_ms() {
 	return chrono::duration <double, milli> (chrono::steady_clock::now() - start).count();
 }
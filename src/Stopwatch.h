@@ -8,6 +8,7 @@ class Stopwatch {
 
   public:
   	void reset();
+  	void reset(double elapsed_ms);
     double elapsed_ms();
 };
 
@@ -0,0 +1,95 @@
+/*
+ThreadPool.cpp: a basic fork-join thread pool, used to spread the work of one search (or of many independent runs) across all cores
+*/
+#include "ThreadPool.h"
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+
+ThreadPool::ThreadPool(int num_threads, bool pin_threads) : _next_task(0), _pin_threads(pin_threads) {
+    num_threads = std::max(1, num_threads);
+    for (int i=1; i < num_threads; ++i) workers.emplace_back(&ThreadPool::worker_loop, this, i);
+    if (_pin_threads) pin_to_core(0);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        _stopping = true;
+    } work_ready.notify_all();
+    for (auto &worker : workers) worker.join();
+}
+
+int ThreadPool::num_threads() const {
+    return workers.size() + 1;
+}
+
+int ThreadPool::hardware_threads() {
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+// Binds the calling thread to a single core
+void ThreadPool::pin_to_core(int thread_idx) {
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(thread_idx % hardware_threads(), &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+#else
+    (void) thread_idx;
+#endif
+}
+
+void ThreadPool::run_tasks(int thread_idx) {
+    for (int task_idx; (task_idx = _next_task.fetch_add(1)) < _num_tasks;) (*_task)(task_idx, thread_idx);
+}
+
+void ThreadPool::worker_loop(int thread_idx) {
+    if (_pin_threads) pin_to_core(thread_idx);
+    long seen_generation = 0;
+    while (true) {
+        {
+            unique_lock<std::mutex> lock(mutex);
+            work_ready.wait(lock, [&] { return _stopping or _generation != seen_generation; });
+            if (_stopping) return;
+            seen_generation = _generation;
+        }
+
+        run_tasks(thread_idx);
+
+        {
+            lock_guard<std::mutex> lock(mutex);
+            if (--_busy_workers == 0) work_done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::parallel_for(int num_tasks, const std::function<void(int task_idx, int thread_idx)> &task) {
+    if (num_tasks <= 0) return;
+
+    // Nothing to gain from waking the workers for a single task
+    if (workers.empty() or num_tasks == 1) {
+        for (int i=0; i < num_tasks; ++i) task(i, 0);
+        return;
+    }
+
+    {
+        lock_guard<std::mutex> lock(mutex);
+        _task           = &task;
+        _num_tasks      = num_tasks;
+        _next_task      = 0;
+        _busy_workers   = workers.size();
+        _generation++;
+    } work_ready.notify_all();
+
+    run_tasks(0);
+
+    unique_lock<std::mutex> lock(mutex);
+    work_done.wait(lock, [&] { return _busy_workers == 0; });
+    _task = nullptr;
+}
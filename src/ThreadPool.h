@@ -0,0 +1,46 @@
+#ifndef CSE6140_THREAD_POOL_
+#define CSE6140_THREAD_POOL_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+    A fixed set of worker threads for fork-join parallelism.  parallel_for hands out task indices dynamically and
+    blocks until every task has run; the calling thread takes part as thread 0, so a pool of N threads spawns N-1.
+    With pin_threads, thread i is bound to core i (modulo the core count) on Linux; elsewhere it is ignored.
+*/
+class ThreadPool {
+    std::vector<std::thread>    workers;
+    std::mutex                  mutex;
+    std::condition_variable     work_ready;
+    std::condition_variable     work_done;
+
+    const std::function<void(int, int)> *_task = nullptr;
+    std::atomic<int>            _next_task;
+    int                         _num_tasks      = 0;
+    int                         _busy_workers   = 0;
+    long                        _generation     = 0;
+    bool                        _stopping       = false;
+    bool                        _pin_threads    = false;
+
+    void worker_loop(int thread_idx);
+    void run_tasks(int thread_idx);
+    static void pin_to_core(int thread_idx);
+
+  public:
+    ThreadPool(int num_threads, bool pin_threads=false);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int num_threads() const;
+    void parallel_for(int num_tasks, const std::function<void(int task_idx, int thread_idx)> &task);
+
+    static int hardware_threads();
+};
+
+#endif
@@ -0,0 +1,234 @@
+/*
+TreeDecomposition.cpp: This module builds tree decompositions from min-degree/min-fill elimination orderings and solves vertex cover exactly on graphs of small treewidth by dynamic programming over the bags
+*/
+#include "TreeDecomposition.h"
+#include "Stopwatch.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <set>
+
+using namespace std;
+
+namespace {
+    const int INF = std::numeric_limits<int>::max() / 2;
+
+    // Pairs of neighbours of the vertex that are not adjacent yet, i.e. the edges eliminating it would add
+    long fill_in(const vector<vector<int>> &adjacency, int vertex) {
+        const auto &neighbors = adjacency[vertex];
+        long missing = 0;
+        for (auto i=0U; i < neighbors.size(); ++i) {
+            const auto &row = adjacency[ neighbors[i] ];
+            for (auto j=i+1; j < neighbors.size(); ++j) {
+                if (not std::binary_search(row.begin(), row.end(), neighbors[j])) missing++;
+            }
+        } return missing;
+    }
+}
+
+TreeDecomposition::TreeDecomposition(const EdgeDenotedGraph &graph, EliminationHeuristic heuristic, int max_width) {
+    if (max_width > MAX_WIDTH) max_width = MAX_WIDTH;
+    auto n = graph.num_vertices();
+    vector<vector<int>> adjacency(n);
+    for (int v=0; v < n; ++v) {
+        graph.for_each_neighbor(v, [&](int neighbor_idx) { if (neighbor_idx != v) adjacency[v].emplace_back(neighbor_idx); });
+        std::sort(adjacency[v].begin(), adjacency[v].end());
+        adjacency[v].erase( std::unique(adjacency[v].begin(), adjacency[v].end()), adjacency[v].end() );
+    }
+
+    // Candidates ordered by (score, vertex); a vertex's score only changes when its neighbourhood does.  Eliminating
+    // a vertex of degree above max_width ends the run whatever its fill-in, so that is not computed for hubs
+    auto score = [&](int v) {
+        auto degree = long(adjacency[v].size());
+        if (heuristic == EliminationHeuristic::MIN_DEGREE) return degree;
+        return (degree > max_width) ? std::numeric_limits<long>::max() / 2 + degree : fill_in(adjacency, v);
+    };
+    vector<long> scores(n);
+    set<pair<long,int>> queue;
+    for (int v=0; v < n; ++v) queue.emplace(scores[v] = score(v), v);
+
+    vector<int> position(n, -1);
+    _separators.resize(n);
+    _parents.assign(n, -1);
+    vector<int> merged, touched;
+    vector<pair<int,int>> fill_edges;
+    while (not queue.empty()) {
+        auto v = queue.begin()->second;
+        queue.erase(queue.begin());
+        auto neighbors = std::move(adjacency[v]);
+        adjacency[v].clear();
+        if (int(neighbors.size()) > max_width) { _width = neighbors.size(); _complete = false; return; }
+
+        position[v] = _order.size();
+        _order.emplace_back(v);
+        _separators[v] = neighbors;
+        _width = std::max(_width, int(neighbors.size()));
+
+        // Connect the neighbours into a clique and drop v from their lists
+        touched.assign(neighbors.begin(), neighbors.end());
+        fill_edges.clear();
+        for (const auto u : neighbors) {
+            auto &row = adjacency[u];
+            if (heuristic == EliminationHeuristic::MIN_FILL) {
+                merged.clear();
+                std::set_difference(neighbors.begin(), neighbors.end(), row.begin(), row.end(), std::back_inserter(merged));
+                for (const auto w : merged) if (u < w) fill_edges.emplace_back(u, w);
+            }
+            merged.clear();
+            std::set_union(row.begin(), row.end(), neighbors.begin(), neighbors.end(), std::back_inserter(merged));
+            merged.erase( std::remove_if(merged.begin(), merged.end(), [&](int w) { return w == u or w == v; }), merged.end() );
+            row.swap(merged);
+        }
+
+        // A new edge (a, b) also removes a missing pair from the neighbourhood of every common neighbour of a and b
+        for (const auto &edge : fill_edges) {
+            const auto &a = adjacency[edge.first], &b = adjacency[edge.second];
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(touched));
+        }
+        std::sort(touched.begin(), touched.end());
+        touched.erase( std::unique(touched.begin(), touched.end()), touched.end() );
+        for (const auto u : touched) {
+            queue.erase(make_pair(scores[u], u));
+            queue.emplace(scores[u] = score(u), u);
+        }
+    }
+
+    // Every separator vertex is eliminated later; the first of them is the parent
+    for (const auto v : _order) {
+        auto &separator = _separators[v];
+        std::sort(separator.begin(), separator.end(), [&](int a, int b) { return position[a] < position[b]; });
+        if (not separator.empty()) _parents[v] = separator.front();
+    }
+}
+
+int TreeDecomposition::width() const {
+    return _width;
+}
+
+bool TreeDecomposition::complete() const {
+    return _complete;
+}
+
+const vector<int>& TreeDecomposition::order() const {
+    return _order;
+}
+
+const vector<int>& TreeDecomposition::separator(int vertex) const {
+    return _separators[vertex];
+}
+
+int TreeDecomposition::parent(int vertex) const {
+    return _parents[vertex];
+}
+
+EliminationHeuristic TreeDecomposition::parse_heuristic(const string &name) {
+    if (name == "min-degree")   return EliminationHeuristic::MIN_DEGREE;
+    if (name == "min-fill")     return EliminationHeuristic::MIN_FILL;
+
+    cout << "[TreeDecomposition] Unknown elimination heuristic '" << name << "'; expected one of [ min-degree, min-fill ]\n";
+    std::exit(-1);
+}
+
+string TreeDecomposition::heuristic_name(EliminationHeuristic heuristic) {
+    switch (heuristic) {
+        case EliminationHeuristic::MIN_DEGREE:  return "min-degree";
+        case EliminationHeuristic::MIN_FILL:    return "min-fill";
+    } return "unknown";
+}
+
+TreeDecompositionSolver::TreeDecompositionSolver(const EdgeDenotedGraph &graph, const TreeDecomposition &decomposition)
+    : _graph(graph), _decomposition(decomposition) {}
+
+void TreeDecompositionSolver::set_cancellation(CancellationHandle token) {
+    _cancellation = std::move(token);
+}
+
+vector<int> TreeDecompositionSolver::solve(double max_ms) {
+    // Returns the cover as a bitfield, or an empty vector if the decomposition is incomplete, or time ran out or the
+    // solve was cancelled first
+    if (not _decomposition.complete()) return {};
+    auto n = _graph.num_vertices();
+    Stopwatch stopwatch;
+
+    vector<vector<int>> children(n);
+    for (const auto v : _decomposition.order()) {
+        if (_decomposition.parent(v) >= 0) children[ _decomposition.parent(v) ].emplace_back(v);
+    }
+
+    vector<vector<int>> tables(n);
+    vector<int> bag_position(n, -1), child_positions;
+    _decisions.assign(n, {});
+    size_t live_bytes = 0;
+
+    for (const auto v : _decomposition.order()) {
+        if ((max_ms > 0 and stopwatch.elapsed_ms() > max_ms) or is_cancelled(_cancellation)) return {};
+        const auto &separator = _decomposition.separator(v);
+        auto k = int(separator.size());
+
+        // Bag bit 0 is v, bit i+1 is separator[i]; edges from v to its separator must be covered here, as this is
+        // the last bag holding v
+        bag_position[v] = 0;
+        for (int i=0; i < k; ++i) bag_position[ separator[i] ] = i + 1;
+        unsigned long must_cover = 0;
+        _graph.for_each_neighbor(v, [&](int neighbor_idx) {
+            if (neighbor_idx != v and bag_position[neighbor_idx] > 0) must_cover |= 1UL << (bag_position[neighbor_idx] - 1);
+        });
+
+        // Where each child's separator vertices sit in this bag
+        child_positions.clear();
+        for (const auto c : children[v]) for (const auto u : _decomposition.separator(c)) child_positions.emplace_back( bag_position[u] );
+
+        auto &table = tables[v];
+        table.assign(size_t(1) << k, INF);
+        auto &decisions = _decisions[v];
+        decisions.assign(((size_t(1) << k) + 63) / 64, 0);
+        for (unsigned long subset=0; subset < (1UL << k); ++subset) {
+            // A wide bag alone can take longer than the cutoff, so check every 2^16 subsets as well as between bags
+            if ((subset & 0xFFFF) == 0xFFFF and ((max_ms > 0 and stopwatch.elapsed_ms() > max_ms) or is_cancelled(_cancellation))) return {};
+            for (int take=0; take <= 1; ++take) {
+                if (not take and (subset & must_cover) != must_cover) continue;
+                auto bag = (subset << 1) | take;
+                long cost = take;
+                auto pos = child_positions.begin();
+                for (const auto c : children[v]) {
+                    unsigned long index = 0;
+                    for (auto j=0U; j < _decomposition.separator(c).size(); ++j) index |= ((bag >> *pos++) & 1UL) << j;
+                    cost += tables[c][index];
+                }
+                if (cost < table[subset]) {
+                    table[subset] = int(std::min<long>(cost, INF));
+                    if (take) decisions[subset / 64] |= uint64_t(1) << (subset % 64);
+                    else decisions[subset / 64] &= ~(uint64_t(1) << (subset % 64));
+                }
+            }
+        }
+        for (const auto u : separator) bag_position[u] = -1;
+        bag_position[v] = -1;
+
+        // The children's tables are no longer needed
+        live_bytes += table.size() * sizeof(int);
+        for (const auto c : children[v]) { live_bytes -= tables[c].size() * sizeof(int); vector<int>().swap(tables[c]); }
+        _peak_table_bytes = std::max(_peak_table_bytes, live_bytes);
+        _decision_bytes += decisions.size() * sizeof(uint64_t);
+    }
+
+    // Top-down: each vertex's separator is decided before it, so its decision bit can be looked up directly
+    vector<int> bitfield(n, 0);
+    const auto &order = _decomposition.order();
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        const auto &separator = _decomposition.separator(*it);
+        unsigned long subset = 0;
+        for (auto i=0U; i < separator.size(); ++i) subset |= (unsigned long)(bitfield[ separator[i] ]) << i;
+        bitfield[*it] = (_decisions[*it][subset / 64] >> (subset % 64)) & 1;
+    } return bitfield;
+}
+
+size_t TreeDecompositionSolver::peak_table_bytes() const {
+    return _peak_table_bytes;
+}
+
+size_t TreeDecompositionSolver::decision_bytes() const {
+    return _decision_bytes;
+}
@@ -0,0 +1,63 @@
+#ifndef CSE6140_TREE_DECOMPOSITION_
+#define CSE6140_TREE_DECOMPOSITION_
+
+#include "EdgeDenotedGraph.h"
+#include "SolverEvents.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class EliminationHeuristic { MIN_DEGREE, MIN_FILL };
+
+/*
+    Tree decomposition from a greedy elimination ordering: repeatedly eliminate the vertex of minimum degree (or of
+    minimum fill-in), turning its remaining neighbours into a clique.  Vertex v's bag is v plus separator(v), its
+    neighbours when it was eliminated, and its parent is the first of those to be eliminated after it.  The width is
+    the largest separator; elimination stops as soon as it would exceed max_width, and complete() is then false.
+    max_width is capped at MAX_WIDTH, the widest bag whose 2^width table the solver can index and allocate.
+*/
+class TreeDecomposition {
+    std::vector<int>                _order;         // vertices in elimination order
+    std::vector<std::vector<int>>   _separators;    // per vertex, sorted by elimination position
+    std::vector<int>                _parents;       // per vertex, or -1 for a root
+    int                             _width      = 0;
+    bool                            _complete   = true;
+
+  public:
+    static const int MAX_WIDTH = 30;
+
+    TreeDecomposition(const EdgeDenotedGraph &graph, EliminationHeuristic heuristic, int max_width);
+    int width() const;
+    bool complete() const;
+    const std::vector<int>& order() const;
+    const std::vector<int>& separator(int vertex) const;
+    int parent(int vertex) const;
+
+    static EliminationHeuristic parse_heuristic(const std::string &name);
+    static std::string heuristic_name(EliminationHeuristic heuristic);
+};
+
+/*
+    Exact minimum vertex cover by dynamic programming over a complete tree decomposition, in O(2^width * n * width)
+    time.  Each bag is handled as the nice decomposition would: introduce the vertex, join its children's tables, and
+    forget it.  The result is a table over the subsets of the separator, holding the smallest cover of the vertices
+    already forgotten.  Value tables are freed once the parent has used them.  The cover is reconstructed from one
+    bit per table entry (whether the vertex was taken), which is all that is kept of each bag.
+*/
+class TreeDecompositionSolver {
+    const EdgeDenotedGraph          &_graph;
+    const TreeDecomposition         &_decomposition;
+    std::vector<std::vector<std::uint64_t>> _decisions;
+    size_t                          _peak_table_bytes   = 0;
+    size_t                          _decision_bytes     = 0;
+    CancellationHandle              _cancellation;
+
+  public:
+    TreeDecompositionSolver(const EdgeDenotedGraph &graph, const TreeDecomposition &decomposition);
+    void set_cancellation(CancellationHandle token);
+    std::vector<int> solve(double max_ms=0);
+    size_t peak_table_bytes() const;
+    size_t decision_bytes() const;
+};
+
+#endif
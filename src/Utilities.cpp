@@ -2,13 +2,16 @@
 Utilities.cpp: functions for generating output filenames given input filenames and parameters
 */
 #include "Utilities.h"
+#include <dirent.h>
+#include <algorithm>
 #include <sstream>
+#include <iostream>
+#include <cstdlib>
 
 using namespace std;
 
 string generate_output_filepath(const std::string &input_filepath, const std::string &method, double cutoff_time_sec, bool trace, int rand_seed) {
-    auto pos = input_filepath.find_last_of("/\\");
-    stringstream ss; ss << input_filepath.substr( pos+1, input_filepath.find(".graph")-pos-1 )
+    stringstream ss; ss << graph_name(input_filepath)
                         << "_" << method << "_" << cutoff_time_sec;
     if (rand_seed != 0) ss << "_" << rand_seed;
 
@@ -25,3 +28,66 @@ string generate_solution_filepath(const string &input_filepath, const string &me
 string generate_trace_filepath(const string &input_filepath, const string &method, double cutoff_time_sec, int rand_seed) {
 	return generate_output_filepath(input_filepath, method, cutoff_time_sec, true, rand_seed);
 }
+
+
+string graph_name(const string &filepath) {
+    // File name without directory or extension, e.g. "data/power.graph" -> "power"
+    auto pos = filepath.find_last_of("/\\");
+    auto name = filepath.substr(pos + 1);
+    return name.substr(0, name.find_last_of('.'));
+}
+
+string join_path(const string &directory, const string &filename) {
+    if (directory.empty()) return filename;
+    if (directory.back() == '/') return directory + filename;
+    return directory + "/" + filename;
+}
+
+vector<string> list_graph_files(const string &directory) {
+    vector<string> filepaths;
+    if (auto dir = opendir(directory.c_str())) {
+        while (auto entry = readdir(dir)) {
+            string name(entry->d_name);
+            if (name.size() > 6 and name.substr(name.size() - 6) == ".graph") filepaths.emplace_back(join_path(directory, name));
+        } closedir(dir);
+    }
+    std::sort(filepaths.begin(), filepaths.end());
+    return filepaths;
+}
+
+Options parse_options(int argc, char** argv, int first_arg_idx) {
+    Options options;
+    for (int i=first_arg_idx; i < argc; ++i) {
+        string arg(argv[i]);
+        if (arg.compare(0, 2, "--") != 0) {
+            cerr << "[Utilities] Expected an option of the form --key=value, but got '" << arg << "'\n";
+            std::exit(-1);
+        }
+        auto pos = arg.find('=');
+        if (pos == string::npos) options[arg.substr(2)] = "1";
+        else options[arg.substr(2, pos-2)] = arg.substr(pos+1);
+    } return options;
+}
+
+string option_string(const Options &options, const string &key, const string &default_value) {
+    auto it = options.find(key);
+    return (it == options.end()) ? default_value : it->second;
+}
+
+double option_double(const Options &options, const string &key, double default_value) {
+    auto it = options.find(key);
+    return (it == options.end()) ? default_value : std::atof(it->second.c_str());
+}
+
+int option_int(const Options &options, const string &key, int default_value) {
+    auto it = options.find(key);
+    return (it == options.end()) ? default_value : std::atoi(it->second.c_str());
+}
+
+vector<string> option_list(const Options &options, const string &key, const string &default_value) {
+    // Comma-separated values, e.g. --seeds=42,194,458
+    vector<string> values;
+    stringstream ss(option_string(options, key, default_value));
+    for (string value; std::getline(ss, value, ',');) if (not value.empty()) values.emplace_back(value);
+    return values;
+}
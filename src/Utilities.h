@@ -2,9 +2,28 @@
 #define CSE6140_UTILITIES_
 
 #include <string>
+#include <map>
+#include <vector>
 
 std::string generate_output_filepath(const std::string &input_filepath, const std::string &method, double cutoff_time_sec, bool trace, int rand_seed=0);
 std::string generate_solution_filepath(const std::string &input_filepath, const std::string &method, double cutoff_time_sec, int rand_seed=0);
 std::string generate_trace_filepath(const std::string &input_filepath, const std::string &method, double cutoff_time_sec, int rand_seed=0);
+std::string graph_name(const std::string &filepath);
+std::string join_path(const std::string &directory, const std::string &filename);
+std::vector<std::string> list_graph_files(const std::string &directory);
+
+// One line of a .trace file: the time at which a better cover was found, and its size
+struct TracePoint {
+    double  time_sec;
+    int     cover_size;
+};
+
+// Command-line options of the form --key=value (or --flag, which is stored as "1"), keyed without the leading dashes
+typedef std::map<std::string, std::string> Options;
+Options parse_options(int argc, char** argv, int first_arg_idx);
+std::string option_string(const Options &options, const std::string &key, const std::string &default_value);
+double option_double(const Options &options, const std::string &key, double default_value);
+int option_int(const Options &options, const std::string &key, int default_value);
+std::vector<std::string> option_list(const Options &options, const std::string &key, const std::string &default_value);
 
 #endif
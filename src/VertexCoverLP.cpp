@@ -0,0 +1,223 @@
+/*
+VertexCoverLP.cpp: This module solves the LP relaxation of vertex cover by bipartite matching on the double cover of the graph, incrementally as vertices are fixed, and applies the Nemhauser-Trotter reduction
+*/
+#include "VertexCoverLP.h"
+#include <limits>
+
+using namespace std;
+
+namespace {
+    const int UNREACHED = std::numeric_limits<int>::max();
+}
+
+VertexCoverLP::VertexCoverLP(const EdgeDenotedGraph &graph) {
+    auto n = graph.num_vertices();
+    _offsets.assign(n + 1, 0);
+    for (int v=0; v < n; ++v) {
+        _offsets[v + 1] = _offsets[v];
+        graph.for_each_neighbor(v, [&](int neighbor_idx) { if (neighbor_idx != v) { _targets.emplace_back(neighbor_idx); _offsets[v + 1]++; } });
+    }
+    _left_active.assign(n, 1);
+    _right_active.assign(n, 1);
+    _left_mate.assign(n, -1);
+    _right_mate.assign(n, -1);
+    _layers.assign(n, UNREACHED);
+    _cursors.assign(n, 0);
+    _stamps.assign(n, 0);
+}
+
+void VertexCoverLP::match(int left, int right) {
+    _left_mate[left] = right;
+    _right_mate[right] = left;
+}
+
+void VertexCoverLP::hopcroft_karp() {
+    // Each phase finds a maximal set of shortest vertex-disjoint augmenting paths; O(sqrt(V)) phases of O(E) each
+    auto n = int(_left_active.size());
+    vector<int> queue;
+    while (true) {
+        queue.clear();
+        for (int u=0; u < n; ++u) {
+            _layers[u] = (_left_active[u] and _left_mate[u] < 0) ? 0 : UNREACHED;
+            if (_layers[u] == 0) queue.emplace_back(u);
+        }
+
+        auto found = false;
+        for (auto head=0U; head < queue.size(); ++head) {
+            auto u = queue[head];
+            for (auto e=_offsets[u]; e < _offsets[u + 1]; ++e) {
+                auto w = _targets[e];
+                if (not _right_active[w]) continue;
+                auto mate = _right_mate[w];
+                if (mate < 0) found = true;
+                else if (_layers[mate] == UNREACHED) { _layers[mate] = _layers[u] + 1; queue.emplace_back(mate); }
+            }
+        }
+        if (not found) return;
+
+        for (int u=0; u < n; ++u) _cursors[u] = _offsets[u];
+        for (int u=0; u < n; ++u) {
+            if (_left_active[u] and _left_mate[u] < 0 and layered_augment(u)) _matching_size++;
+        }
+    }
+}
+
+bool VertexCoverLP::layered_augment(int root) {
+    // Iterative DFS along the BFS layers; a left vertex that leads nowhere is taken out of its layer for the phase
+    _path.assign(1, root);
+    while (not _path.empty()) {
+        auto u = _path.back();
+        if (_cursors[u] == _offsets[u + 1]) { _layers[u] = UNREACHED; _path.pop_back(); continue; }
+
+        auto w = _targets[ _cursors[u] ];
+        auto mate = _right_active[w] ? _right_mate[w] : -2;
+        if (mate == -1) {
+            for (const auto left : _path) match(left, _targets[ _cursors[left] ]);
+            return true;
+        }
+        if (mate >= 0 and _layers[mate] == _layers[u] + 1) _path.emplace_back(mate);
+        else _cursors[u]++;
+    } return false;
+}
+
+bool VertexCoverLP::augment_from_left(int root) {
+    // Alternating DFS from a free left copy: unmatched edge to R_w, then R_w's matched edge back to the left side
+    _stamp++;
+    _stamps[root] = _stamp;
+    _cursors[root] = _offsets[root];
+    _path.assign(1, root);
+    while (not _path.empty()) {
+        auto u = _path.back();
+        if (_cursors[u] == _offsets[u + 1]) { _path.pop_back(); if (not _path.empty()) _cursors[ _path.back() ]++; continue; }
+
+        auto w = _targets[ _cursors[u] ];
+        if (not _right_active[w]) { _cursors[u]++; continue; }
+        auto mate = _right_mate[w];
+        if (mate < 0) {
+            for (const auto left : _path) match(left, _targets[ _cursors[left] ]);
+            return true;
+        }
+        if (_stamps[mate] != _stamp) { _stamps[mate] = _stamp; _cursors[mate] = _offsets[mate]; _path.emplace_back(mate); }
+        else _cursors[u]++;
+    } return false;
+}
+
+bool VertexCoverLP::augment_from_right(int root) {
+    // The same search from a free right copy: unmatched edge to L_u, then L_u's matched edge to R_{mate(u)}.  The
+    // double cover is symmetric, so R_w's neighbours are the L copies of w's neighbours; stamps mark left copies
+    _stamp++;
+    _cursors[root] = _offsets[root];
+    _path.assign(1, root);
+    while (not _path.empty()) {
+        auto w = _path.back();
+        if (_cursors[w] == _offsets[w + 1]) { _path.pop_back(); if (not _path.empty()) _cursors[ _path.back() ]++; continue; }
+
+        auto u = _targets[ _cursors[w] ];
+        if (not _left_active[u] or _stamps[u] == _stamp) { _cursors[w]++; continue; }
+        _stamps[u] = _stamp;
+        auto mate = _left_mate[u];
+        if (mate < 0) {
+            // Walk back along the path, rematching every left copy on it to the right copy before it
+            for (const auto right : _path) {
+                auto left = _targets[ _cursors[right] ];
+                match(left, right);
+            } return true;
+        }
+        _cursors[mate] = _offsets[mate];
+        _path.emplace_back(mate);
+    } return false;
+}
+
+void VertexCoverLP::solve() {
+    if (not _solved) { hopcroft_karp(); _solved = true; }
+}
+
+void VertexCoverLP::deactivate(int vertex) {
+    // Before the first solve() this only shrinks the graph; afterwards each copy's removal is repaired at once
+    if (not _left_active[vertex]) return;
+    _left_active[vertex] = 0;
+    auto right = _left_mate[vertex];
+    if (right >= 0) {
+        _left_mate[vertex] = _right_mate[right] = -1;
+        _matching_size--;
+        if (_solved and augment_from_right(right)) _matching_size++;
+    }
+
+    _right_active[vertex] = 0;
+    auto left = _right_mate[vertex];
+    if (left >= 0) {
+        _right_mate[vertex] = _left_mate[left] = -1;
+        _matching_size--;
+        if (_solved and augment_from_left(left)) _matching_size++;
+    }
+}
+
+void VertexCoverLP::activate(int vertex) {
+    if (_left_active[vertex]) return;
+    _left_active[vertex] = 1;
+    if (_solved and augment_from_left(vertex)) _matching_size++;
+    _right_active[vertex] = 1;
+    if (_solved and augment_from_right(vertex)) _matching_size++;
+}
+
+bool VertexCoverLP::is_active(int vertex) const {
+    return _left_active[vertex];
+}
+
+int VertexCoverLP::matching_size() const {
+    return _matching_size;
+}
+
+int VertexCoverLP::lower_bound() const {
+    // The LP optimum is matching_size / 2, and a cover has a whole number of vertices
+    return (_matching_size + 1) / 2;
+}
+
+vector<int> VertexCoverLP::doubled_solution() {
+    // Returns 2 * x_v (0, 1 or 2) for every vertex, 0 for inactive ones.  Konig: Z is everything reachable from the
+    // free left copies by alternating paths, and the cover is (left copies outside Z) + (right copies inside Z)
+    solve();
+    auto n = int(_left_active.size());
+    vector<char> left_reached(n, 0), right_reached(n, 0);
+    vector<int> queue;
+    for (int u=0; u < n; ++u) {
+        if (_left_active[u] and _left_mate[u] < 0) { left_reached[u] = 1; queue.emplace_back(u); }
+    }
+    for (auto head=0U; head < queue.size(); ++head) {
+        auto u = queue[head];
+        for (auto e=_offsets[u]; e < _offsets[u + 1]; ++e) {
+            auto w = _targets[e];
+            if (not _right_active[w] or right_reached[w]) continue;
+            right_reached[w] = 1;
+            auto mate = _right_mate[w];
+            if (mate >= 0 and not left_reached[mate]) { left_reached[mate] = 1; queue.emplace_back(mate); }
+        }
+    }
+
+    vector<int> doubled(n, 0);
+    for (int v=0; v < n; ++v) {
+        if (_left_active[v]) doubled[v] = int(not left_reached[v]) + int(right_reached[v]);
+    } return doubled;
+}
+
+LPReduction::LPReduction(const EdgeDenotedGraph &graph) {
+    VertexCoverLP lp(graph);
+    auto doubled = lp.doubled_solution();
+    lower_bound = lp.lower_bound();
+
+    mapping.new_ids.assign(graph.num_vertices(), -1);
+    mapping.input_ids = graph.original_ids();
+    for (int v=0; v < graph.num_vertices(); ++v) {
+        if (doubled[v] == 1) mapping.original_ids.emplace_back(v);
+        else if (doubled[v] == 2) num_in_cover++;
+        else num_excluded++;
+    }
+
+    if (mapping.original_ids.empty()) {
+        num_in_cover = num_excluded = 0;
+        for (int v=0; v < graph.num_vertices(); ++v) mapping.original_ids.emplace_back(v);
+    } else {
+        for (int v=0; v < graph.num_vertices(); ++v) if (doubled[v] == 2) mapping.fixed_cover.emplace_back(v);
+    }
+    for (auto new_id=0U; new_id < mapping.original_ids.size(); ++new_id) mapping.new_ids[ mapping.original_ids[new_id] ] = new_id;
+}
@@ -0,0 +1,62 @@
+#ifndef CSE6140_VERTEX_COVER_LP_
+#define CSE6140_VERTEX_COVER_LP_
+
+#include "EdgeDenotedGraph.h"
+#include "VertexOrdering.h"
+#include <vector>
+
+/*
+    LP relaxation of vertex cover, solved as bipartite matching on the double cover of the graph: every vertex v has
+    a left copy L_v and a right copy R_v, and every edge (u, v) becomes L_u-R_v and L_v-R_u.  A maximum matching M
+    there is twice the LP optimum, and Konig's theorem turns it into a minimum vertex cover C of the double cover,
+    from which x_v = ([L_v in C] + [R_v in C]) / 2 is an optimal half-integral LP solution.
+
+    solve() runs Hopcroft-Karp.  After that, vertices can be deactivated (e.g. when branch and bound decides them) and
+    reactivated (when it backtracks), and the LP is then over the subgraph induced by the active vertices.  Each change
+    keeps the matching maximum with at most two searches: removing or adding one copy changes the maximum by at most
+    one, and any augmenting path must end at the copy that was freed or added.  (Changing several copies first and
+    searching afterwards is not enough: two freed copies can be matched to each other when two longer paths existed.)
+*/
+class VertexCoverLP {
+    std::vector<int>    _offsets, _targets;         // adjacency of the graph in CSR form
+    std::vector<char>   _left_active, _right_active;
+    std::vector<int>    _left_mate, _right_mate;    // _left_mate[u] = w if L_u-R_w is matched, else -1
+    std::vector<int>    _layers, _cursors, _stamps, _path;
+    int                 _stamp          = 0;
+    int                 _matching_size  = 0;
+    bool                _solved         = false;
+
+    void hopcroft_karp();
+    bool layered_augment(int root);
+    bool augment_from_left(int root);
+    bool augment_from_right(int root);
+    void match(int left, int right);
+
+  public:
+    VertexCoverLP(const EdgeDenotedGraph &graph);
+    void solve();
+    void deactivate(int vertex);
+    void activate(int vertex);
+    bool is_active(int vertex) const;
+
+    int matching_size() const;
+    int lower_bound() const;
+    std::vector<int> doubled_solution();
+};
+
+/*
+    Nemhauser-Trotter reduction: some minimum cover contains every vertex with x_v = 1 in an optimal half-integral
+    LP solution and no vertex with x_v = 0.  mapping fixes the former in mapping.fixed_cover, drops both, and keeps
+    the x_v = 1/2 vertices, whose own minimum cover is at least half their number.  If the LP is integral everywhere
+    the graph is left as it is, so a solver still has something to run on.
+*/
+struct LPReduction {
+    int             lower_bound     = 0;
+    int             num_in_cover    = 0;
+    int             num_excluded    = 0;
+    VertexMapping   mapping;
+
+    LPReduction(const EdgeDenotedGraph &graph);
+};
+
+#endif
@@ -0,0 +1,134 @@
+/*
+VertexOrdering.cpp: This module computes cache-friendly relabellings of the graph (BFS or Reverse Cuthill-McKee order), and maps bitfields over the relabelled graph back to the original vertex ids.
+*/
+#include "VertexOrdering.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+
+using namespace std;
+
+namespace {
+    // Visits every component in BFS order, starting each component at its lowest-degree vertex when sort_by_degree is set
+    vector<int> breadth_first_order(const EdgeDenotedGraph &graph, bool sort_by_degree) {
+        auto num_vertices = graph.num_vertices();
+        vector<int> order; order.reserve(num_vertices);
+        vector<char> visited(num_vertices, 0);
+        vector<int> neighbors;
+
+        vector<int> starts(num_vertices);
+        for (int i=0; i < num_vertices; ++i) starts[i] = i;
+        if (sort_by_degree) {
+            std::stable_sort(starts.begin(), starts.end(), [&](int a, int b) { return graph.degree(a) < graph.degree(b); });
+        }
+
+        for (const auto start : starts) {
+            if (visited[start]) continue;
+            visited[start] = 1;
+            auto head = order.size();
+            order.emplace_back(start);
+
+            while (head < order.size()) {
+                auto vertex = order[head++];
+                neighbors.clear();
+                graph.for_each_neighbor(vertex, [&](int neighbor_idx) {
+                    if (not visited[neighbor_idx]) { visited[neighbor_idx] = 1; neighbors.emplace_back(neighbor_idx); }
+                });
+                // Cuthill-McKee visits the unvisited neighbours in ascending order of degree
+                if (sort_by_degree) {
+                    std::sort(neighbors.begin(), neighbors.end(), [&](int a, int b) {
+                        return graph.degree(a) < graph.degree(b) or (graph.degree(a) == graph.degree(b) and a < b);
+                    });
+                }
+                order.insert(order.end(), neighbors.begin(), neighbors.end());
+            }
+        } return order;
+    }
+}
+
+VertexMapping::VertexMapping(const EdgeDenotedGraph &graph, OrderingType type) {
+    switch (type) {
+        case OrderingType::NATURAL:
+            original_ids.resize(graph.num_vertices());
+            for (auto i=0U; i < original_ids.size(); ++i) original_ids[i] = i;
+            break;
+        case OrderingType::BFS:
+            original_ids = breadth_first_order(graph, false);
+            break;
+        case OrderingType::RCM:
+            original_ids = breadth_first_order(graph, true);
+            std::reverse(original_ids.begin(), original_ids.end());
+            break;
+    }
+
+    new_ids.resize(original_ids.size());
+    for (auto i=0U; i < original_ids.size(); ++i) new_ids[ original_ids[i] ] = i;
+    input_ids = graph.original_ids();
+}
+
+bool VertexMapping::is_identity() const {
+    if (original_ids.size() != new_ids.size()) return false;
+    for (auto i=0U; i < original_ids.size(); ++i) {
+        if (original_ids[i] != int(i)) return false;
+    } return true;
+}
+
+RawMetisFile VertexMapping::apply(const RawMetisFile &file) const {
+    RawMetisFile relabelled;
+    relabelled.Connections.resize(original_ids.size());
+    for (auto new_id=0U; new_id < original_ids.size(); ++new_id) {
+        auto &row = relabelled.Connections[new_id];
+        for (const auto neighbor_idx : file.Connections[ original_ids[new_id] ]) {
+            if (new_ids[neighbor_idx] >= 0) row.emplace_back( new_ids[neighbor_idx] );
+        }
+        std::sort(row.begin(), row.end());
+    }
+    if (not file.OriginalIds.empty()) {
+        relabelled.OriginalIds.resize(original_ids.size());
+        for (auto new_id=0U; new_id < original_ids.size(); ++new_id) relabelled.OriginalIds[new_id] = file.OriginalIds[ original_ids[new_id] ];
+    }
+    if (file.is_weighted()) {
+        relabelled.VertexWeights.resize(original_ids.size());
+        for (auto new_id=0U; new_id < original_ids.size(); ++new_id) relabelled.VertexWeights[new_id] = file.VertexWeights[ original_ids[new_id] ];
+    } return relabelled;
+}
+
+VertexMapping VertexMapping::then(const VertexMapping &next) const {
+    // The mapping that applies this one and then next (whose old ids are this one's new ids)
+    if (original_ids.empty()) return next;
+    VertexMapping composed;
+    composed.new_ids.assign(new_ids.size(), -1);
+    for (auto new_id=0U; new_id < next.original_ids.size(); ++new_id) {
+        composed.original_ids.emplace_back( original_ids[ next.original_ids[new_id] ] );
+        composed.new_ids[ composed.original_ids.back() ] = new_id;
+    }
+    composed.fixed_cover = fixed_cover;
+    for (const auto vertex : next.fixed_cover) composed.fixed_cover.emplace_back( original_ids[vertex] );
+    composed.input_ids = input_ids;
+    return composed;
+}
+
+vector<int> VertexMapping::to_original(const vector<int> &bitfield) const {
+    vector<int> original(new_ids.size(), 0);
+    for (auto new_id=0U; new_id < bitfield.size(); ++new_id) original[ original_ids[new_id] ] = bitfield[new_id];
+    for (const auto vertex : fixed_cover) original[vertex] = 1;
+    return original;
+}
+
+OrderingType VertexMapping::parse_type(const string &name) {
+    if (name == "none" or name == "natural")    return OrderingType::NATURAL;
+    if (name == "bfs")                          return OrderingType::BFS;
+    if (name == "rcm")                          return OrderingType::RCM;
+
+    cout << "[VertexOrdering] Unknown ordering '" << name << "'; expected one of [ none, bfs, rcm ]\n";
+    std::exit(-1);
+}
+
+string VertexMapping::type_name(OrderingType type) {
+    switch (type) {
+        case OrderingType::NATURAL: return "none";
+        case OrderingType::BFS:     return "bfs";
+        case OrderingType::RCM:     return "rcm";
+    } return "unknown";
+}
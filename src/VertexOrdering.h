@@ -0,0 +1,36 @@
+#ifndef VERTEX_ORDERING_H_
+#define VERTEX_ORDERING_H_
+
+#include "EdgeDenotedGraph.h"
+#include "RawMetisFile.h"
+#include <string>
+#include <vector>
+
+enum class OrderingType { NATURAL, BFS, RCM };
+
+/*
+    Relabelling of the vertices of a graph, so that neighbouring vertices get nearby ids (and so nearby rows of the
+    adjacency lists and nearby bits of the bitfield).  Solvers run on the relabelled graph and map their solutions
+    back to the original ids before writing them out.
+
+    A mapping can also drop vertices whose part of the cover is already decided (e.g. components solved exactly):
+    those have no new id, and the ones that belong in the cover are listed in fixed_cover and set by to_original().
+*/
+struct VertexMapping {
+    std::vector<int>    original_ids;   // original_ids[new_id] = old_id
+    std::vector<int>    new_ids;        // new_ids[old_id] = new_id, or -1 if the vertex was dropped
+    std::vector<int>    fixed_cover;    // old ids of dropped vertices that are in the cover
+    std::vector<long>   input_ids;      // the original graph's RawMetisFile::OriginalIds, for writing solutions
+
+    VertexMapping() = default;
+    VertexMapping(const EdgeDenotedGraph &graph, OrderingType type);
+    bool is_identity() const;
+    RawMetisFile apply(const RawMetisFile &file) const;
+    VertexMapping then(const VertexMapping &next) const;
+    std::vector<int> to_original(const std::vector<int> &bitfield) const;
+
+    static OrderingType parse_type(const std::string &name);
+    static std::string type_name(OrderingType type);
+};
+
+#endif
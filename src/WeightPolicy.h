@@ -0,0 +1,35 @@
+#ifndef WEIGHT_POLICY_H_
+#define WEIGHT_POLICY_H_
+
+/*
+    Vertex weight policies, for the hot loops that are templated on whether the graph is weighted.  UnitWeights gives
+    every vertex a compile-time weight of 1, so the unweighted instantiations compile to the same code as before
+    weights existed; GraphWeights reads the graph's contiguous weight array.  normalized() is a vertex's weight over
+    the largest weight, in (0, 1], for energies and fitnesses whose penalty constants were tuned for unit vertices.
+
+    with_weight_policy(graph, f) checks once whether the graph is weighted and calls f with the matching policy, so
+    the check is made per operation rather than per bit.  Both work on any graph type with EdgeDenotedGraph's weight
+    accessors (EdgeDenotedGraph, CompressedGraph).
+*/
+struct UnitWeights {
+    int operator[](int) const { return 1; }
+    double normalized(int) const { return 1.0; }
+};
+
+struct GraphWeights {
+    const int   *weights;
+    double      scale;
+
+    template <typename Graph>
+    explicit GraphWeights(const Graph &graph) : weights(graph.vertex_weights().data()), scale(1.0 / graph.max_vertex_weight()) {}
+    int operator[](int vertex) const { return weights[vertex]; }
+    double normalized(int vertex) const { return weights[vertex] * scale; }
+};
+
+template <typename Graph, typename F>
+auto with_weight_policy(const Graph &graph, F &&f) -> decltype(f(UnitWeights())) {
+    if (graph.is_weighted()) return f(GraphWeights(graph));
+    return f(UnitWeights());
+}
+
+#endif